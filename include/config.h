@@ -0,0 +1,87 @@
+/**
+ * @file config.h
+ * @author D. Heger
+ * @brief Runtime configuration loaded from environment variables
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include "constants.h"
+#include "present.h"
+#include "cube.h"
+#include "mesh.h"
+#include "scene.h"
+
+/* Environment variable names */
+#define ENV_RENDER_THREADS      "CUBE_THREADS"      /**< Worker thread count, 0 for one per CPU */
+#define ENV_OUTPUT_MODE         "CUBE_OUTPUT"       /**< Terminal output strategy: threaded, nonblocking or blocking */
+#define ENV_TARGET_FPS          "CUBE_FPS"          /**< Paced frame rate, 0 for the fixed frame timer */
+#define ENV_HUGE_PAGES          "CUBE_HUGE_PAGES"   /**< 1 to back the renderer arena with huge pages */
+#define ENV_MESH                "CUBE_MESH"         /**< OBJ/PLY model to draw instead of the cube, or "cube" for the built-in mesh */
+#define ENV_INSTANCES           "CUBE_INSTANCES"    /**< Number of mesh instances laid out as a scene, 0 for a single object */
+#define ENV_INSTANCE_LAYERS     "CUBE_INSTANCE_LAYERS" /**< Layers the instances are stacked in, one behind the other */
+#define ENV_OCCLUSION           "CUBE_OCCLUSION"    /**< 0 to draw scenes without occlusion culling */
+
+/** CUBE_MESH value selecting the cube built as a mesh by createCubeMesh() */
+#define MESH_BUILTIN_CUBE       "cube"
+
+/**
+ * @brief Settings of the interactive program that can be tuned at launch
+ */
+typedef struct
+{
+    int renderThreads;              /**< Threads used by the tiled renderer (0 = one per CPU) */
+    PresentOutputMode outputMode;   /**< How frames reach the terminal */
+    int targetFps;                  /**< Deadline-paced frame rate (0 = fixed FRAME_DELAY_MICROSEC timer) */
+    int hugePages;                  /**< Request huge pages for the renderer arena (see RenderContext::hugePages) */
+    const char* meshPath;           /**< Model file to draw, MESH_BUILTIN_CUBE, or NULL for drawCube() */
+    int instanceCount;              /**< Instances of the mesh drawn with drawScene(), 0 for none */
+    int instanceLayers;             /**< Layers the instances are split over */
+    int occlusionCulling;           /**< Scene::occlusionCulling of the scene */
+} RuntimeConfig;
+
+/**
+ * @brief Load the runtime configuration from the environment
+ *
+ * Unset variables keep their defaults. Invalid values print a warning to
+ * stderr and fall back to the default.
+ *
+ * @return The resolved configuration
+ */
+RuntimeConfig loadRuntimeConfig(void);
+
+/**
+ * @brief Load the mesh named by RuntimeConfig::meshPath
+ *
+ * Builds the cube mesh for MESH_BUILTIN_CUBE, or when no path is set (as
+ * scenes always need a mesh); model files are loaded with loadMesh() and
+ * fitted to the cube's size so they fill the same view.
+ *
+ * @param config The resolved configuration
+ * @param cube The cube whose size and culling the mesh takes
+ * @param mesh Receives the mesh
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
+ */
+int loadConfiguredMesh(const RuntimeConfig* config, const CubeObject* cube, Mesh* mesh);
+
+/**
+ * @brief Lay out RuntimeConfig::instanceCount instances of a mesh
+ *
+ * Instances sit in RuntimeConfig::instanceLayers layers of square grids
+ * of SCENE_INSTANCE_SCALE copies, spaced SCENE_INSTANCE_SPACING
+ * half-extents apart; large counts extend well past the window, where
+ * frustum culling drops them, and deep stacks hide their back layers,
+ * which occlusion culling drops.
+ *
+ * @param config The resolved configuration
+ * @param cube The cube whose size the mesh was fitted to
+ * @param mesh The mesh every instance draws
+ * @param scene Receives the scene
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
+ */
+int loadConfiguredScene(const RuntimeConfig* config, const CubeObject* cube, const Mesh* mesh, Scene* scene);
+
+#endif // CONFIG_H
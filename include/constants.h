@@ -24,15 +24,53 @@
 /* Cube geometry constants */
 #define DEFAULT_CUBE_WIDTH      10.0f                           /**< Default cube width/height/depth */
 #define CUBE_INCREMENT_STEP     1.0f                            /**< Step size for cube surface iteration */
+#define CUBE_REANCHOR_INTERVAL  16                              /**< Incremental traversal steps between exact re-anchors */
 
 /* Rendering constants */
 #define DEFAULT_VIEWER_DISTANCE     60                          /**< Distance from viewer to cube center */
 #define DEFAULT_PROJECTION_SCALE    40.0f                       /**< Projection scale factor for perspective */
 #define BACKGROUND_CHARACTER        ' '                         /**< Character used for background/empty space */
+#define RENDER_BATCH_SIZE           256                         /**< Points projected per batch kernel invocation */
+#define RENDER_TILE_WIDTH           32                          /**< Width of a parallel render tile in cells */
+#define RENDER_TILE_HEIGHT          8                           /**< Height of a parallel render tile in cells */
+#define COARSE_DEPTH_TILE           8                           /**< Cells along each side of a coarse (hierarchical-Z) depth tile */
+#define PACKED_DEPTH_MAX            0xFFFFu                     /**< Largest 16-bit fixed-point inverse depth of a packed cell */
+#define PACKED_DEPTH_NEAR_FRACTION  0.5f                        /**< Nearest distance packed cells resolve, relative to the viewer distance */
+#define RENDER_ARENA_ALIGNMENT      64                          /**< Byte alignment of every renderer arena section */
+#define RENDER_HUGE_PAGE_SIZE       (2u * 1024u * 1024u)        /**< Arena size granularity when huge pages are requested */
+
+/* Mesh constants */
+#define MESH_MAX_VERTICES           (1 << 24)                   /**< Largest vertex count of a loaded mesh */
+#define MESH_MAX_TRIANGLES          (1 << 24)                   /**< Largest triangle count of a loaded mesh */
+#define MESH_SHADE_RAMP             ".,-~:;=!*#$@"              /**< Triangle characters from facing away to facing the viewer */
+#define MESH_PLY_MAX_ELEMENTS       16                          /**< Element types a PLY header may declare */
+#define MESH_PLY_MAX_PROPERTIES     32                          /**< Properties a PLY element may declare */
+#define MESH_PLY_MAX_WORD           64                          /**< Longest PLY header word (names and types) */
+
+/* Scene constants */
+#define SCENE_MAX_INSTANCES         (1 << 20)                   /**< Largest number of instances in a scene */
+#define SCENE_GRID_CELL_INSTANCES   8                           /**< Average instances per spatial grid cell */
+#define SCENE_GRID_MAX_CELLS        256                         /**< Largest number of grid cells along one axis */
+#define SCENE_BATCH_INSTANCES       32                          /**< Instances transformed per batch, and drawn between coarse depth refreshes */
+#define SCENE_INSTANCE_SCALE        0.25f                       /**< Scale of each instance in the CUBE_INSTANCES layout */
+#define SCENE_INSTANCE_SPACING      3.0f                        /**< Instance spacing in the CUBE_INSTANCES layout, in instance half-extents */
+
+/* Threading constants */
+#define DEFAULT_RENDER_THREADS      1                           /**< Worker threads used when none are configured */
+#define MAX_RENDER_THREADS          64                          /**< Upper bound on configured worker threads */
+#define RENDER_STEAL_CHUNK_ROWS     8                           /**< Face rows per work-stealing item */
+
+/* Presentation constants */
+#define PRESENT_BACKLOG_LIMIT       4096                        /**< Queued terminal bytes above which non-blocking output skips frames */
 
 /* Animation constants */
 #define ROTATION_INCREMENT      0.005f                          /**< Rotation speed per frame (radians) */
-#define FRAME_DELAY_MICROSEC    1000                            /**< Delay between frames in microseconds */
+#define FRAME_DELAY_MICROSEC    1000                            /**< Frame timer period in microseconds */
+
+/* Pacing constants */
+#define MAX_TARGET_FPS              1000                        /**< Highest configurable paced frame rate */
+#define PACING_MAX_CATCHUP_FRAMES   4                           /**< Late periods rendered back to back before the schedule jumps ahead */
+#define PACING_SAMPLE_CAPACITY      65536                       /**< Most recent frame latenesses kept for percentiles */
 
 /* Input constants */
 #define EXIT_KEY_CODE           '1'                             /**< Key code to exit the program */
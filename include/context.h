@@ -0,0 +1,155 @@
+/**
+ * @file context.h
+ * @author D. Heger
+ * @brief Render context owning all per-instance renderer and cube state
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "constants.h"
+#include "renderer.h"
+#include "cube.h"
+#include "mesh.h"
+#include "scene.h"
+#include "worksteal.h"
+
+/**
+ * @brief One independent renderer instance
+ *
+ * Holds what used to be process-wide state: the settings a caller may change
+ * between frames, the buffers managed by initializeRenderer(),
+ * resizeRenderer() and cleanupRenderer(), and bookkeeping private to the
+ * renderer and the work-stealing scheduler. Functions taking a context touch
+ * no other mutable state except the shared worker pool, so contexts on
+ * different threads render concurrently without locking.
+ *
+ * Set up with initializeRenderContext() before initializeRenderer(); fields
+ * below the settings must not be written by callers.
+ */
+struct RenderContext
+{
+    /* Settings */
+
+    /** Character used for background/empty cells (typically ' ') */
+    int backgroundChar;
+
+    /**
+     * Distance from the viewer to the cube center. Larger values create less
+     * perspective distortion, smaller values more dramatic perspective.
+     */
+    int viewerDistance;
+
+    /** Perspective projection scale: how large the projected cube appears */
+    float projectionScaleFactor;
+
+    /**
+     * Depth buffer layout used by initializeDepthBuffer() and the depth test.
+     *
+     * DEPTH_BUFFER_CLEARED (the default) keeps zBuffer and zeroes it every
+     * frame. DEPTH_BUFFER_EPOCH stores each cell as (epoch << 32) | bits of
+     * its inverse depth in 64-bit cells: a cell whose epoch is older than
+     * the current frame counts as cleared, so clearing is O(1) and the depth
+     * test stays a single unsigned compare. zBuffer is not written in this
+     * mode.
+     *
+     * DEPTH_BUFFER_PACKED interleaves depth and glyph in one 4-byte cell,
+     * (fixed-point inverse depth << 16) | glyph, so a depth test touches a
+     * single cache line instead of one in each of zBuffer and frameBuffer.
+     * Inverse depth is scaled so that distances down to
+     * PACKED_DEPTH_NEAR_FRACTION * viewerDistance use the full 16 bits;
+     * nearer cells saturate. Glyphs reach frameBuffer through
+     * resolveFrameBuffer().
+     *
+     * Changing the mode between frames clears the newly selected storage in
+     * full; the new mode takes effect at the next initializeDepthBuffer().
+     */
+    DepthBufferMode depthBufferMode;
+
+    /**
+     * Back the arena with huge pages. When non-zero, initializeRenderer()
+     * rounds the arena up to RENDER_HUGE_PAGE_SIZE and maps it with
+     * MAP_HUGETLB, or, if no huge pages are reserved, advises the kernel to
+     * use transparent huge pages (madvise(MADV_HUGEPAGE)). Falls back to
+     * regular pages silently; see getRendererArena() for the outcome.
+     */
+    int hugePages;
+
+    /** The rendered object, its modes and its animation state */
+    CubeObject cube;
+
+    /**
+     * Mesh drawn with drawMesh() instead of the cube, or NULL. Not owned by
+     * the context; cube.rotation still drives its animation.
+     */
+    Mesh* mesh;
+
+    /**
+     * Scene drawn with drawScene() instead of the mesh or the cube, or NULL.
+     * Not owned by the context; cube.rotation spins every instance.
+     */
+    Scene* scene;
+
+    /* Buffers (read-only for callers) */
+
+    int windowWidth;            /**< Display width in characters */
+    int windowHeight;           /**< Display height in characters */
+    int bufferSize;             /**< windowWidth * windowHeight */
+
+    /**
+     * Inverse depth (1/z) per cell for Z-buffering. Shares the arena's depth
+     * section with the other depth layouts, so its contents are only
+     * meaningful in DEPTH_BUFFER_CLEARED mode.
+     */
+    float* zBuffer;
+
+    /** Display character per cell, row-major; the arena's glyph section
+     *  unless bindRendererFrameBuffer() bound caller storage */
+    char* frameBuffer;
+
+    /** The single block all buffers above are carved from */
+    RenderArena arena;
+
+    /* Renderer bookkeeping */
+
+    uint64_t* depthKeys;                /**< Depth section viewed as epoch-tagged cells */
+    uint32_t depthEpoch;                /**< Current frame epoch; 0 marks cleared cells */
+    uint32_t* packedCells;              /**< Depth section viewed as packed cells */
+    float packedDepthScale;             /**< Inverse depth to fixed-point factor */
+    int depthStorageStale;              /**< Whole depth storage needs clearing (resize, mode change) */
+    DepthBufferMode activeDepthMode;    /**< Layout the depth section currently holds */
+    float* coarseDepth;                 /**< Farthest inverse depth per COARSE_DEPTH_TILE tile, row-major */
+
+    RenderRect drawnRect;               /**< Cells written this frame, grown atomically */
+    RenderRect previousDrawnRect;       /**< drawnRect of the previous frame */
+    RenderRect frameStaleRect;          /**< frameBuffer cells still to be cleared */
+    RenderRect depthStaleRect;          /**< Depth cells still to be cleared */
+
+    /* Work-stealing scheduler bookkeeping. The private buffers are not
+     * carved from the arena: their size follows the thread pool, so the
+     * scheduler allocates them separately on first use. */
+
+    float* threadDepth;                 /**< Private depth buffers of pool threads 1..n-1 (packed cells in packed mode) */
+    char* threadFrame;                  /**< Private glyph buffers of pool threads 1..n-1 */
+    size_t threadBufferCapacity;        /**< Cells allocated across all private buffers */
+    WorkStealStats stealStats;          /**< Counters of the most recent renderWorkStealing() */
+};
+
+/**
+ * @brief Give a context its default settings and no buffers
+ *
+ * Sets the default projection, background character and depth buffer mode,
+ * and the default cube via initializeCubeObject(). Allocates nothing; adjust
+ * the settings, then call initializeRenderer().
+ *
+ * @param context The context to initialize
+ *
+ * @note Must not be called on a context that still owns buffers
+ */
+void initializeRenderContext(RenderContext* context);
+
+#endif // CONTEXT_H
@@ -11,65 +11,192 @@
 
 #include "math3d.h"
 #include "constants.h"
+#include "renderer.h"
+#include "mesh.h"
 
 /**
- * @brief Current cube size (width/height/depth)
- * 
- * Defines the dimensions of the cube in world coordinates. The cube
- * extends from -cubeWidth to +cubeWidth in all three axes, creating
- * a cube with total dimension of 2*cubeWidth per side.
+ * @brief Strategies for turning cube faces into screen cells
  */
-extern float cubeWidth;
+typedef enum
+{
+    CUBE_RENDER_SAMPLED = 0,    /**< Point-sample each face every incrementStep */
+    CUBE_RENDER_RASTERIZED      /**< Project the corners and scan-convert each face quad */
+} CubeRenderMode;
 
 /**
- * @brief Surface sampling resolution step size
- * 
- * Controls the density of points generated on each cube face. Smaller
- * values create more detailed surfaces but increase rendering cost.
- * Must be positive and less than cubeWidth for proper coverage.
+ * @brief Ways of generating surface samples in sampled mode
  */
-extern float cubeIncrementStep;
+typedef enum
+{
+    CUBE_TRAVERSAL_TRANSFORM = 0,   /**< Build each sample in object space and rotate it */
+    CUBE_TRAVERSAL_INCREMENTAL      /**< Forward-difference samples in rotated space */
+} CubeTraversalMode;
 
 /**
- * @brief Current animation rotation state
- * 
- * Tracks the current rotation angles for animated cube display.
- * Values are continuously updated by incrementRotationAngles() to
- * create smooth rotation animation.
+ * @brief How drawCube() spreads a frame over the worker pool
+ */
+typedef enum
+{
+    CUBE_PARALLEL_TILED = 0,        /**< Threads claim screen tiles and render every face overlapping them */
+    CUBE_PARALLEL_WORK_STEALING     /**< Threads steal face row chunks and merge per-thread depth buffers */
+} CubeParallelMode;
+
+/**
+ * @brief Back-face culling counters for the most recent drawCube() call
  */
-extern Rotation3D rotationAngles;
+typedef struct
+{
+    int facesTested;        /**< Faces classified this frame */
+    int facesCulled;        /**< Faces skipped because they point away from the viewer */
+    long samplesCulled;     /**< Surface samples skipped with the culled faces (sampled mode) */
+} CubeCullStats;
+
+/**
+ * @brief The cube drawn by a render context and its animation state
+ *
+ * Lives in RenderContext::cube; initializeCubeObject() sets the defaults.
+ */
+typedef struct
+{
+    /**
+     * Cube size: the cube extends from -width to +width in all three axes,
+     * for a total dimension of 2 * width per side.
+     */
+    float width;
+
+    /**
+     * Surface sampling resolution step size. Smaller values create more
+     * detailed surfaces but increase rendering cost. Must be positive and
+     * less than width for proper coverage.
+     */
+    float incrementStep;
+
+    /**
+     * Active face rendering strategy. CUBE_RENDER_RASTERIZED (the default)
+     * costs one depth test per covered screen cell independent of width.
+     * CUBE_RENDER_SAMPLED keeps the original point-sampled look whose cost
+     * scales with (2 * width / incrementStep)^2.
+     */
+    CubeRenderMode renderMode;
+
+    /**
+     * Enable per-frame back-face culling. When non-zero (the default), faces
+     * whose rotated normal points away from the viewer are skipped before
+     * any per-point or per-cell work. At most three faces of a convex cube
+     * can be visible at once.
+     */
+    int backFaceCulling;
+
+    /**
+     * Sample generation strategy used by CUBE_RENDER_SAMPLED.
+     * CUBE_TRAVERSAL_INCREMENTAL (the default) transforms each face origin
+     * and its two step vectors once per frame and reaches every sample by
+     * vector addition, reducing per-sample cost to a few adds plus the
+     * projection.
+     */
+    CubeTraversalMode traversalMode;
+
+    /**
+     * Steps between exact re-anchors in incremental traversal. Every
+     * reanchorInterval rows (and columns within a row) the sample position
+     * is recomputed from the face origin instead of accumulated, which
+     * bounds floating-point drift on finely sampled faces. 0 disables
+     * re-anchoring.
+     */
+    int reanchorInterval;
+
+    /**
+     * Work distribution used when the worker pool has several threads.
+     * CUBE_PARALLEL_TILED (the default) needs no extra memory but renders a
+     * face once per tile it overlaps. CUBE_PARALLEL_WORK_STEALING generates
+     * each face exactly once, in chunks of RENDER_STEAL_CHUNK_ROWS rows, at
+     * the cost of one private depth and glyph buffer per extra thread.
+     * Both produce the same frame: samples of equal depth resolve to the
+     * smaller glyph whichever thread or tile writes them first.
+     */
+    CubeParallelMode parallelMode;
+
+    /**
+     * Current animation rotation, advanced by incrementRotationAngles().
+     */
+    Rotation3D rotation;
+
+    /**
+     * Culling counters of the most recent drawCube() call.
+     */
+    CubeCullStats cullStats;
+} CubeObject;
+
+/**
+ * @brief Set a cube object to the default size, modes and rotation
+ *
+ * @param cube The object to initialize
+ */
+void initializeCubeObject(CubeObject* cube);
 
 /**
  * @brief Render all six faces of the cube with rotation applied
  *
- * Generates surface points for all six cube faces and renders them through
- * the projection pipeline. Each face is represented by a different character:
- * - 'A': Front face (z = -cubeWidth)
- * - 'B': Right face (x = +cubeWidth)  
- * - 'C': Left face (x = -cubeWidth)
- * - 'D': Back face (z = +cubeWidth)
- * - 'E': Bottom face (y = -cubeWidth)
- * - 'F': Top face (y = +cubeWidth)
+ * Renders all six faces of the context's cube through the projection
+ * pipeline using the strategy selected by its renderMode. Each face is
+ * represented by a different character:
+ * - 'A': Front face (z = -width)
+ * - 'B': Right face (x = +width)  
+ * - 'C': Left face (x = -width)
+ * - 'D': Back face (z = +width)
+ * - 'E': Bottom face (y = -width)
+ * - 'F': Top face (y = +width)
  *
+ * @param context The context to render into; its cube settings are read
+ *                and its culling counters updated
  * @param rotation The 3D rotation angles to apply to all cube points (in radians)
  * 
- * @note Calls calculateForSurface() for each generated point
- * @note Surface density controlled by cubeIncrementStep value
+ * @note Builds the rotation transform, face visibility and projected corners
+ *       once per call, then renders through renderTiled() or
+ *       renderWorkStealing() as selected by parallelMode
+ * @note Sampled mode submits each face in RENDER_BATCH_SIZE point batches,
+ *       generated as selected by traversalMode; density is set by
+ *       incrementStep
+ * @note Rasterized mode projects the eight corners once and passes each face
+ *       to rasterizeQuad()
+ * @note Finishes with resolveFrameBuffer(), so the context's frameBuffer is
+ *       ready to present
  * @note Does not perform bounds checking on rotation parameters
  */
-void drawCube(Rotation3D rotation);
+void drawCube(RenderContext* context, Rotation3D rotation);
+
+/**
+ * @brief Build a cube as a triangle mesh
+ *
+ * Two triangles per face with the glyphs used by drawCube(), so drawMesh()
+ * renders the same picture as rasterized drawCube() through the generic
+ * mesh path. The cube's width and backFaceCulling carry over.
+ *
+ * @param mesh Receives the mesh; release it with destroyMesh()
+ * @param cube The cube settings to build from
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
+ */
+int createCubeMesh(Mesh* mesh, const CubeObject* cube);
+
+/**
+ * @brief Get the culling counters recorded by the last drawCube() call
+ *
+ * @param context The context that drew the frame
+ * @return Face and sample counts for the most recent frame
+ */
+CubeCullStats getCubeCullStats(const RenderContext* context);
 
 /**
  * @brief Update rotation angles for animation
  *
- * Advances the global rotation state by fixed increments to create
+ * Advances the cube's rotation state by fixed increments to create
  * smooth animated rotation. Updates both X and Y rotation angles
  * simultaneously for diagonal spinning effect.
  *
- * @note Modifies the global rotationAngles variable
+ * @param context The context whose cube.rotation is advanced
  * @note Rotation increment is defined by ROTATION_INCREMENT constant
  * @note No bounds checking - angles will continue increasing indefinitely
  */
-void incrementRotationAngles(void);
+void incrementRotationAngles(RenderContext* context);
 
 #endif // CUBE_H
\ No newline at end of file
@@ -0,0 +1,73 @@
+/**
+ * @file eventloop.h
+ * @author D. Heger
+ * @brief epoll-driven event loop over input, signals and the frame timer
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#ifndef EVENTLOOP_H
+#define EVENTLOOP_H
+
+#include <time.h>
+#include "constants.h"
+
+/**
+ * @brief Event flags returned by waitForEvents(), combined bitwise
+ */
+typedef enum
+{
+    LOOP_EVENT_FRAME  = 1 << 0,     /**< The frame timer expired */
+    LOOP_EVENT_INPUT  = 1 << 1,     /**< stdin has data to read */
+    LOOP_EVENT_RESIZE = 1 << 2,     /**< SIGWINCH was received */
+    LOOP_EVENT_QUIT   = 1 << 3      /**< SIGINT or SIGTERM was received */
+} LoopEvent;
+
+/**
+ * @brief Set up the epoll set, signalfd and frame timerfd
+ *
+ * Blocks SIGWINCH, SIGINT and SIGTERM so they are only seen through the
+ * signalfd, and starts a periodic timer that fires every frame.
+ *
+ * @param framePeriodMicroseconds Interval between frame ticks, or 0 to
+ *                                schedule each tick with scheduleFrameTick()
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
+ *
+ * @note Call before starting any thread: threads inherit the blocked
+ *       signals, otherwise they would receive SIGINT with its default action
+ * @note stdin is only watched if it supports epoll (terminals and pipes)
+ */
+int initializeEventLoop(long framePeriodMicroseconds);
+
+/**
+ * @brief Arm the frame timer for one tick at an absolute time
+ *
+ * The timer fires once at the given CLOCK_MONOTONIC time (immediately if it
+ * has passed), replacing any periodic or pending tick. Waiting in
+ * waitForEvents() for such a deadline behaves like
+ * clock_nanosleep(TIMER_ABSTIME) while still waking up for keys and signals.
+ *
+ * @param deadline Absolute CLOCK_MONOTONIC time of the next frame
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
+ */
+int scheduleFrameTick(const struct timespec* deadline);
+
+/**
+ * @brief Sleep until at least one event is pending and collect all of them
+ *
+ * Timer expirations and signals are consumed; stdin is only reported and
+ * must be read by the caller (e.g. isKeyPressed()), otherwise it keeps
+ * being reported. stdin stops being watched once it reaches end of input.
+ *
+ * @return Bitwise OR of LoopEvent flags, or ALLOCATION_FAILURE on error
+ */
+int waitForEvents(void);
+
+/**
+ * @brief Close the event descriptors and restore the signal mask
+ *
+ * @note Safe to call multiple times or without initializeEventLoop()
+ */
+void cleanupEventLoop(void);
+
+#endif // EVENTLOOP_H
@@ -1,7 +1,7 @@
 /**
  * @file input.h
  * @author D. Heger
- * @brief Terminal input handling and timing functions
+ * @brief Terminal input handling functions
  * @version 1.1.0
  * @date 2025-08-05
  */
@@ -14,11 +14,13 @@
 /**
  * @brief Configure terminal for non-blocking input detection
  *
- * Switches the terminal to non-canonical mode with echo disabled,
- * enabling immediate key detection without requiring Enter key press.
+ * Switches the terminal to non-canonical mode with echo disabled and
+ * zero-timeout reads, enabling immediate key detection without requiring
+ * Enter key press. The original settings are saved for resetTerminalMode().
  * This is essential for real-time interactive applications.
  *
  * @note Must call resetTerminalMode() before program exit to restore terminal
+ * @note Configures the terminal once; repeated calls do nothing
  * @note May fail silently if terminal attributes cannot be modified
  */
 void setNonBlockingMode(void);
@@ -26,8 +28,9 @@ void setNonBlockingMode(void);
 /**
  * @brief Restore terminal to original canonical mode
  *
- * Reverts terminal settings to canonical mode with echo enabled,
- * restoring normal command-line behavior. Critical to call before
+ * Reverts terminal settings to those saved by setNonBlockingMode(), or
+ * to canonical mode with echo enabled if they were never saved, restoring
+ * normal command-line behavior. Critical to call before
  * program termination to prevent terminal corruption.
  *
  * @note Should be called in cleanup routines and signal handlers
@@ -38,32 +41,29 @@ void resetTerminalMode(void);
 /**
  * @brief Non-blocking check for exit key press
  *
- * Performs a non-blocking poll of stdin to detect if the designated
- * exit key has been pressed. Uses temporary terminal mode changes
- * to achieve non-blocking behavior without affecting global state.
+ * Polls stdin with a zero timeout and reads any pending keys to detect
+ * if the designated exit key has been pressed. Relies on the terminal
+ * mode set once by setNonBlockingMode(), so a frame without input costs
+ * a single poll() call.
  *
  * @return int Returns 1 if EXIT_KEY_CODE is pressed, 0 otherwise
  * 
  * @note Currently hardcoded to detect '1' key (EXIT_KEY_CODE)
- * @note Temporarily modifies terminal settings during execution
+ * @note Other pending keys are consumed and ignored
  * @note Returns immediately without blocking program execution
  */
 int isKeyPressed(void);
 
 /**
- * @brief Precise microsecond delay for animation timing
+ * @brief Query the size of the terminal attached to stdout
  *
- * Provides sub-millisecond precision timing delays using the system's
- * usleep() function. Used to control animation frame rate and ensure
- * smooth cube rotation visualization.
+ * @param columns Receives the number of character columns
+ * @param rows Receives the number of text rows
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if stdout is not
+ *         a terminal or reports no size
  *
- * @param sleep_microseconds Duration to wait in microseconds (1/1,000,000 second)
- *                          Valid range: 0 to 999,999 microseconds
- * 
- * @note Large values may be rounded to system timer resolution
- * @note Function may return early if interrupted by signals
- * @note Parameter renamed for clarity (was 'sleep')
+ * @note Uses the TIOCGWINSZ ioctl; call again after SIGWINCH
  */
-void wait(int sleep_microseconds);
+int getTerminalSize(int* columns, int* rows);
 
 #endif // INPUT_H
\ No newline at end of file
@@ -0,0 +1,98 @@
+/**
+ * @file libcube.h
+ * @author D. Heger
+ * @brief Public API of the embeddable cube renderer (libcube.a / libcube.so)
+ *
+ * Self-contained: embedders include only this header and link build/libcube.a
+ * or build/libcube.so (plus -lm -pthread for the static library). Each
+ * CubeRenderer is independent, so renderers on different threads run in
+ * parallel. Nothing here touches a terminal.
+ *
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#ifndef LIBCUBE_H
+#define LIBCUBE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Marks the symbols exported by libcube.so; everything else stays hidden */
+#define CUBE_API __attribute__((visibility("default")))
+
+#define CUBE_SUCCESS        0       /**< Return code of a successful call */
+#define CUBE_FAILURE        -1      /**< Return code of a failed call */
+
+#define CUBE_MIN_WIDTH      10      /**< Smallest frame width in cells */
+#define CUBE_MIN_HEIGHT     5       /**< Smallest frame height in cells */
+#define CUBE_MAX_WIDTH      200     /**< Largest frame width in cells */
+#define CUBE_MAX_HEIGHT     100     /**< Largest frame height in cells */
+
+/**
+ * @brief Opaque handle of one renderer instance
+ */
+typedef struct CubeRenderer CubeRenderer;
+
+/**
+ * @brief Create a renderer producing frames of the given size
+ *
+ * All memory the renderer needs is allocated here, sized for the largest
+ * supported frame, so neither rendering nor resizing allocates.
+ *
+ * @param width Frame width in cells (CUBE_MIN_WIDTH..CUBE_MAX_WIDTH)
+ * @param height Frame height in cells (CUBE_MIN_HEIGHT..CUBE_MAX_HEIGHT)
+ * @return The renderer, or NULL on invalid dimensions or allocation failure
+ */
+CUBE_API CubeRenderer* createCubeRenderer(int width, int height);
+
+/**
+ * @brief Change the size of subsequent frames
+ *
+ * @param renderer The renderer to resize
+ * @param width New frame width in cells
+ * @param height New frame height in cells
+ * @return CUBE_SUCCESS on success, CUBE_FAILURE on invalid arguments
+ */
+CUBE_API int resizeCubeRenderer(CubeRenderer* renderer, int width, int height);
+
+/**
+ * @brief Render the cube at the given rotation into a caller buffer
+ *
+ * The frame is rasterized straight into frame: one glyph byte per cell,
+ * row-major, width * height bytes, with no newlines or terminator. Empty
+ * cells hold ' ' and the six faces the characters 'A' to 'F'. Nothing is
+ * copied or allocated.
+ *
+ * Only cells the cube covered in this or the previous frame are rewritten,
+ * so the buffer must not be modified between frames rendered into it.
+ * Passing a different buffer than last time clears it in full first.
+ *
+ * @param renderer The renderer to use
+ * @param angleX Rotation about the X axis in radians
+ * @param angleY Rotation about the Y axis in radians
+ * @param angleZ Rotation about the Z axis in radians
+ * @param frame Destination glyph buffer
+ * @param frameSize Size of frame in bytes, at least width * height
+ * @return CUBE_SUCCESS on success, CUBE_FAILURE on invalid arguments
+ *
+ * @note A renderer must not be used from two threads at once
+ */
+CUBE_API int renderCubeFrame(CubeRenderer* renderer, float angleX, float angleY, float angleZ,
+                             char* frame, size_t frameSize);
+
+/**
+ * @brief Release a renderer and all its memory
+ *
+ * @param renderer The renderer to destroy, or NULL
+ */
+CUBE_API void destroyCubeRenderer(CubeRenderer* renderer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBCUBE_H
@@ -35,6 +35,49 @@ typedef struct
     float z;    /**< Rotation around Z-axis (roll) in radians */
 } Rotation3D;
 
+/**
+ * @brief Precomputed 3x3 rotation transform
+ *
+ * Row-major rotation matrix built once per frame from a Rotation3D so that
+ * points can be rotated with nine multiply-adds instead of evaluating the
+ * trigonometric expansion for every point. Row 0 produces the rotated X,
+ * row 1 the rotated Y and row 2 the rotated Z coordinate.
+ */
+typedef struct
+{
+    float m[3][3];  /**< Matrix coefficients indexed as m[row][column] */
+} Transform3D;
+
+/**
+ * @brief Perspective projection parameters for batched point processing
+ *
+ * Captures the renderer's projection state so that batched kernels can
+ * project points without touching renderer state. The projection used is:
+ * - inverseDepth = 1 / (z + viewerDistance)
+ * - screenX = centerX + scaleX * inverseDepth * x
+ * - screenY = centerY + scaleY * inverseDepth * y
+ */
+typedef struct
+{
+    float viewerDistance;   /**< Offset added to rotated Z (camera distance) */
+    float scaleX;           /**< Horizontal scale (doubled for character aspect) */
+    float scaleY;           /**< Vertical scale */
+    float centerX;          /**< Screen-space X of the projection center */
+    float centerY;          /**< Screen-space Y of the projection center */
+} Projection3D;
+
+/**
+ * @brief Instruction set variants of the batched transform kernel
+ */
+typedef enum
+{
+    TRANSFORM_KERNEL_SCALAR = 0,    /**< Portable scalar fallback */
+    TRANSFORM_KERNEL_SSE2,          /**< 4-wide SSE2 implementation */
+    TRANSFORM_KERNEL_AVX2,          /**< 8-wide AVX2 implementation */
+    TRANSFORM_KERNEL_AVX512,        /**< 16-wide AVX-512F implementation */
+    TRANSFORM_KERNEL_COUNT          /**< Number of kernel variants */
+} TransformKernel;
+
 /**
  * @brief Calculate transformed X coordinate after 3D rotation
  * 
@@ -77,4 +120,107 @@ float calculateY(Point3D point, Rotation3D rotation);
  */
 float calculateZ(Point3D point, Rotation3D rotation);
 
+/**
+ * @brief Build the rotation transform matching calculateX/Y/Z
+ *
+ * Evaluates the sine and cosine of each rotation angle once and stores the
+ * combined X/Y/Z rotation as a 3x3 matrix. Transforming a point with the
+ * result is equivalent to calling calculateX(), calculateY() and
+ * calculateZ() with the same rotation.
+ *
+ * @param rotation The rotation angles to encode (in radians)
+ * @return The combined rotation transform
+ */
+Transform3D buildRotationTransform(Rotation3D rotation);
+
+/**
+ * @brief Apply a precomputed rotation transform to a point
+ *
+ * @param transform The transform built by buildRotationTransform()
+ * @param point The original 3D point before transformation
+ * @return The rotated point
+ *
+ * @note This function does not validate input parameters
+ */
+Point3D transformPoint(const Transform3D* transform, Point3D point);
+
+/**
+ * @brief Rotate and project a batch of points stored as structure-of-arrays
+ *
+ * Applies the rotation transform and perspective projection to count points
+ * read from the x, y and z arrays. Uses the fastest kernel supported by the
+ * CPU (detected via CPUID at startup) unless overridden with
+ * setTransformKernel(). All kernel variants produce bit-identical results.
+ *
+ * Points at or behind the viewer (z + viewerDistance <= 0) are reported with
+ * an inverse depth of 0 and screen coordinates of -1, so they never pass a
+ * depth test against a cleared depth buffer. Screen coordinates are truncated
+ * toward zero; values outside the int range are reported as INT_MIN.
+ *
+ * @param transform The per-frame rotation transform
+ * @param projection The projection parameters to apply
+ * @param x Input X coordinates
+ * @param y Input Y coordinates
+ * @param z Input Z coordinates
+ * @param count Number of points to process
+ * @param screenX Output screen columns
+ * @param screenY Output screen rows
+ * @param inverseDepth Output inverse depth (1/z) values
+ *
+ * @note Input and output arrays need no particular alignment
+ * @note This function does not validate input parameters
+ */
+void transformProjectBatch(const Transform3D* transform, const Projection3D* projection,
+                           const float* x, const float* y, const float* z, int count,
+                           int* screenX, int* screenY, float* inverseDepth);
+
+/**
+ * @brief Project a batch of already rotated points stored as structure-of-arrays
+ *
+ * Same projection and output conventions as transformProjectBatch(), but
+ * skips the rotation: the inputs are camera-aligned coordinates relative to
+ * the object center (projection->viewerDistance is still added to z).
+ * Dispatched to the same kernel variant as transformProjectBatch().
+ *
+ * @param projection The projection parameters to apply
+ * @param x Input rotated X coordinates
+ * @param y Input rotated Y coordinates
+ * @param z Input rotated Z coordinates
+ * @param count Number of points to process
+ * @param screenX Output screen columns
+ * @param screenY Output screen rows
+ * @param inverseDepth Output inverse depth (1/z) values
+ *
+ * @note This function does not validate input parameters
+ */
+void projectBatch(const Projection3D* projection,
+                  const float* x, const float* y, const float* z, int count,
+                  int* screenX, int* screenY, float* inverseDepth);
+
+/**
+ * @brief Get the kernel variant currently used by transformProjectBatch()
+ *
+ * @return The active kernel
+ */
+TransformKernel getTransformKernel(void);
+
+/**
+ * @brief Override the kernel variant used by transformProjectBatch()
+ *
+ * @param kernel The kernel variant to activate
+ * @return 1 if the kernel is supported on this CPU and was activated, 0 otherwise
+ *
+ * @note Intended for benchmarking and verification; the startup selection is
+ *       already the fastest supported variant
+ */
+int setTransformKernel(TransformKernel kernel);
+
+/**
+ * @brief Get a short human-readable name for a kernel variant
+ *
+ * @param kernel The kernel variant
+ * @return Static name string ("scalar", "sse2", "avx2", "avx512" or "unknown")
+ */
+const char* getTransformKernelName(TransformKernel kernel);
+
 #endif // MATH3D_H
\ No newline at end of file
@@ -0,0 +1,168 @@
+/**
+ * @file mesh.h
+ * @author D. Heger
+ * @brief Indexed triangle meshes, OBJ/PLY loading and mesh rendering
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#ifndef MESH_H
+#define MESH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "math3d.h"
+#include "renderer.h"
+
+/**
+ * @brief Indexed triangle mesh stored as structure-of-arrays
+ *
+ * Geometry and the per-frame scratch that drawMesh() fills are carved out of
+ * one allocation; only the tile bins are allocated separately, as their
+ * size depends on the view. Triangles wind counter-clockwise when seen from outside,
+ * as in OBJ and PLY files.
+ */
+typedef struct
+{
+    float* x;               /**< Object-space X coordinate per vertex */
+    float* y;               /**< Object-space Y coordinate per vertex */
+    float* z;               /**< Object-space Z coordinate per vertex */
+    int vertexCount;        /**< Number of vertices */
+
+    int* indices;           /**< Three vertex indices per triangle */
+    float* normalX;         /**< Unit object-space normal X per triangle */
+    float* normalY;         /**< Unit object-space normal Y per triangle */
+    float* normalZ;         /**< Unit object-space normal Z per triangle */
+    char* glyphs;           /**< Fixed character per triangle, or NULL to shade by facing */
+    int triangleCount;      /**< Number of triangles */
+
+    /**
+     * Skip triangles facing away from the viewer. Only correct for closed,
+     * consistently wound meshes; loaded meshes start with it off.
+     */
+    int backFaceCulling;
+
+    /* Per-frame scratch written by drawMesh() */
+
+    float* screenX;         /**< Projected column per vertex */
+    float* screenY;         /**< Projected row per vertex */
+    float* inverseDepth;    /**< Projected inverse depth per vertex, 0 behind the viewer */
+    char* shading;          /**< Facing-ramp character per triangle when glyphs is NULL */
+    uint32_t* tileSpans;    /**< Packed range of render tiles per triangle when the pool is used */
+    int* tileBins;          /**< Triangles per render tile, grown on demand when the pool is used */
+    size_t tileBinCapacity; /**< Entries allocated in tileBins */
+
+    void* block;            /**< The single allocation all arrays are carved from */
+} Mesh;
+
+/**
+ * @brief Allocate an empty mesh of the given size
+ *
+ * Positions and indices are left for the caller to fill; call
+ * updateMeshNormals() afterwards.
+ *
+ * @param mesh The mesh to set up
+ * @param vertexCount Number of vertices (1..MESH_MAX_VERTICES)
+ * @param triangleCount Number of triangles (1..MESH_MAX_TRIANGLES)
+ * @param withGlyphs Non-zero to allocate the fixed per-triangle glyphs
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
+ */
+int initializeMesh(Mesh* mesh, int vertexCount, int triangleCount, int withGlyphs);
+
+/**
+ * @brief Load a Wavefront OBJ or ASCII/binary PLY file
+ *
+ * The file is memory-mapped and parsed in two passes over the mapping, one
+ * to size the mesh and one to fill it, so startup costs no read() copies
+ * and a single allocation. The format is taken from the "ply" magic line,
+ * anything else is parsed as OBJ. Polygons are split into triangle fans;
+ * texture coordinates, normals and other attributes are ignored.
+ *
+ * @param mesh Receives the mesh
+ * @param path Path of the model file
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if the file
+ *         cannot be mapped, is malformed or references missing vertices
+ *
+ * @note Prints the reason for a failure to stderr
+ */
+int loadMesh(Mesh* mesh, const char* path);
+
+/**
+ * @brief Recompute the triangle normals from the positions and indices
+ *
+ * @param mesh The mesh to update
+ */
+void updateMeshNormals(Mesh* mesh);
+
+/**
+ * @brief Center a mesh on the origin and scale it to a given size
+ *
+ * The bounding box center moves to the origin and its largest half-extent
+ * becomes halfExtent, so any model fits the view of a default cube.
+ *
+ * @param mesh The mesh to transform
+ * @param halfExtent Target half-extent (e.g. the cube width)
+ */
+void fitMesh(Mesh* mesh, float halfExtent);
+
+/**
+ * @brief Place, rotate and project vertices [begin, end) of a mesh
+ *
+ * A vertex p becomes offset + scale * transform * p and is projected with
+ * the projectVertex() convention, so meshes and quads of the same geometry
+ * land on the same cells. Vertices at or behind the viewer get an inverse
+ * depth of 0.
+ *
+ * @param mesh The mesh to read positions from
+ * @param transform Rotation to apply
+ * @param scale Uniform scale applied after the rotation
+ * @param offset Translation applied after the scale
+ * @param projection Projection of the target context
+ * @param begin First vertex to project
+ * @param end One past the last vertex to project
+ * @param screenX Receives the projected column per vertex (indexed like the mesh)
+ * @param screenY Receives the projected row per vertex
+ * @param inverseDepth Receives the inverse depth per vertex
+ */
+void projectMeshVertices(const Mesh* mesh, const Transform3D* transform, float scale, Point3D offset,
+                         const Projection3D* projection, int begin, int end,
+                         float* screenX, float* screenY, float* inverseDepth);
+
+/**
+ * @brief Pick the MESH_SHADE_RAMP character of triangles [begin, end)
+ *
+ * @param mesh The mesh to read normals from
+ * @param transform Rotation of the mesh this frame
+ * @param begin First triangle to shade
+ * @param end One past the last triangle to shade
+ * @param shading Receives one character per triangle (indexed like the mesh)
+ */
+void shadeMeshTriangles(const Mesh* mesh, const Transform3D* transform, int begin, int end, char* shading);
+
+/**
+ * @brief Render a mesh into a context's buffers
+ *
+ * Every vertex is rotated and projected once per frame (split across the
+ * worker pool), then the triangles are rasterized as screen tiles with
+ * rasterizeTriangles(). With several pool threads the triangles are first
+ * sorted into per-tile bins, so each tile only visits the triangles
+ * overlapping it. Triangles without fixed glyphs are shaded from
+ * MESH_SHADE_RAMP by how directly they face the viewer.
+ *
+ * @param context The context to render into
+ * @param mesh The mesh to draw; its scratch arrays are overwritten
+ * @param rotation The rotation to apply
+ *
+ * @note A mesh must not be drawn by two contexts at once
+ * @note Allocates only when a frame needs more tile bin entries than any before it
+ */
+void drawMesh(RenderContext* context, Mesh* mesh, Rotation3D rotation);
+
+/**
+ * @brief Release a mesh's memory
+ *
+ * @param mesh The mesh to release; safe to call on a released mesh
+ */
+void destroyMesh(Mesh* mesh);
+
+#endif // MESH_H
@@ -0,0 +1,79 @@
+/**
+ * @file pacing.h
+ * @author D. Heger
+ * @brief Deadline-based frame pacing with lateness statistics
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#ifndef PACING_H
+#define PACING_H
+
+#include <time.h>
+#include "constants.h"
+
+/**
+ * @brief Lateness of paced frames relative to their deadlines
+ *
+ * Lateness is how long after its deadline a frame actually started, so the
+ * percentiles describe the jitter of the refresh rate.
+ */
+typedef struct
+{
+    long frames;                /**< Frames started through beginPacedFrame() */
+    long missedDeadlines;       /**< Frames that started a full period or more after their deadline */
+    long periodsSkipped;        /**< Periods dropped because the loop fell too far behind */
+    double meanLatenessMs;      /**< Average lateness */
+    double p50LatenessMs;       /**< Median lateness */
+    double p95LatenessMs;       /**< 95th percentile lateness */
+    double p99LatenessMs;       /**< 99th percentile lateness */
+    double maxLatenessMs;       /**< Worst lateness */
+} FramePacingStats;
+
+/**
+ * @brief Start a fresh deadline schedule at the given frame rate
+ *
+ * The first deadline is one period from now; statistics are reset.
+ *
+ * @param targetFps Frames per second (1..MAX_TARGET_FPS)
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if the rate is
+ *         out of range or the clock cannot be read
+ */
+int initializeFramePacer(int targetFps);
+
+/**
+ * @brief Get the absolute CLOCK_MONOTONIC time the next frame is due
+ *
+ * @return The current deadline
+ */
+struct timespec getFrameDeadline(void);
+
+/**
+ * @brief Sleep until the current deadline with clock_nanosleep(TIMER_ABSTIME)
+ *
+ * Absolute deadlines do not accumulate the time spent rendering, so the
+ * frame rate does not drift with load. Returns immediately if the deadline
+ * has already passed.
+ */
+void waitForFrameDeadline(void);
+
+/**
+ * @brief Record the start of a frame and advance the schedule
+ *
+ * Measures the lateness against the current deadline and moves the
+ * deadline one period on. After an overrun the following frames are due
+ * immediately, which catches up on the lost periods; once more than
+ * PACING_MAX_CATCHUP_FRAMES periods are behind, the schedule jumps ahead
+ * instead and the dropped periods are counted.
+ */
+void beginPacedFrame(void);
+
+/**
+ * @brief Get the lateness statistics since initializeFramePacer()
+ *
+ * @return Counters and lateness percentiles over the most recent
+ *         PACING_SAMPLE_CAPACITY frames
+ */
+FramePacingStats getFramePacingStats(void);
+
+#endif // PACING_H
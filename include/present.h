@@ -0,0 +1,214 @@
+/**
+ * @file present.h
+ * @author D. Heger
+ * @brief Terminal presentation stage of the renderer
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#ifndef PRESENT_H
+#define PRESENT_H
+
+#include <stddef.h>
+#include "constants.h"
+#include "renderer.h"
+
+/**
+ * @brief Largest encoded frame: screen clear, cursor-home prefix and one byte per cell
+ */
+#define PRESENT_OUTPUT_CAPACITY (sizeof(CLEAR_SCREEN_SEQ) - 1 + sizeof(HOME_CURSOR_SEQ) - 1 + \
+                                 (size_t)MAX_WINDOW_WIDTH * MAX_WINDOW_HEIGHT)
+
+/**
+ * @brief Byte counters of the frames sent by presentFrame()
+ */
+typedef struct
+{
+    long fullFrames;        /**< Frames sent as a complete redraw */
+    long deltaFrames;       /**< Frames sent as changed runs only (including empty deltas) */
+    long bytesWritten;      /**< Total bytes handed to write() */
+    long framesDropped;     /**< Frames replaced by a newer one before the present thread reached them */
+    long framesSkipped;     /**< Frames not sent by presentFrameNonBlocking() because output was backed up */
+    long framesPartial;     /**< Frames whose bytes did not all fit and were finished on a later call */
+} PresentStats;
+
+/**
+ * @brief Ways the interactive loop can get frames to the terminal
+ */
+typedef enum
+{
+    PRESENT_OUTPUT_THREADED = 0,    /**< Present thread fed through a triple buffer */
+    PRESENT_OUTPUT_NONBLOCKING,     /**< Non-blocking writes from the render loop, skipping frames when backed up */
+    PRESENT_OUTPUT_BLOCKING         /**< Blocking write from the render loop */
+} PresentOutputMode;
+
+/**
+ * @brief Send only the cells that changed since the previous frame
+ *
+ * When non-zero (the default), presentFrame() compares each frame with the
+ * one it sent last and emits the changed runs behind cursor-positioning
+ * sequences, falling back to a full redraw whenever that is not smaller.
+ */
+extern int presentDeltaEncoding;
+
+/**
+ * @brief Encode a frame as the bytes sent to the terminal
+ *
+ * Writes HOME_CURSOR_SEQ followed by every row, where the first cell of each
+ * row is replaced by the newline that starts it. Rows are copied whole, so
+ * there is no per-cell branching.
+ *
+ * @param frame Glyph per cell, row-major
+ * @param width Cells per row (1..MAX_WINDOW_WIDTH)
+ * @param height Number of rows (1..MAX_WINDOW_HEIGHT)
+ * @param output Destination with room for PRESENT_OUTPUT_CAPACITY bytes
+ * @return Number of bytes written to output, or 0 if the dimensions are invalid
+ */
+size_t encodeFrame(const char* frame, int width, int height, char* output);
+
+/**
+ * @brief Encode only the cells of a frame that differ from the previous one
+ *
+ * Each changed run is preceded by an absolute cursor move, or a relative
+ * move within the same row. Unchanged cells between two runs are resent
+ * when that is shorter than the escape sequence that would skip them.
+ *
+ * @param frame Glyph per cell of the new frame, row-major
+ * @param previous Glyph per cell of the frame currently on screen
+ * @param width Cells per row (1..MAX_WINDOW_WIDTH)
+ * @param height Number of rows (1..MAX_WINDOW_HEIGHT)
+ * @param region Cells to compare, or NULL for the whole frame; cells outside
+ *               it must be equal in both frames
+ * @param output Destination with room for limit bytes
+ * @param limit Largest acceptable encoding, normally the full frame length
+ * @param length Receives the number of bytes written (0 if nothing changed)
+ * @return 1 if the delta fits within limit, 0 if it does not or the
+ *         dimensions are invalid
+ */
+int encodeFrameDelta(const char* frame, const char* previous, int width, int height,
+                     const RenderRect* region, char* output, size_t limit, size_t* length);
+
+/**
+ * @brief Encode a context's frame into its arena's output buffer and write it
+ *
+ * Sends the smaller of a delta against the last presented frame and a full
+ * redraw (see presentDeltaEncoding). The bytes leave in a single write()
+ * unless the kernel accepts them only partially, in which case the
+ * remainder is written until done. Nothing is written if no cell changed.
+ *
+ * With the drawn rectangles of this frame and the last presented one, only
+ * their union is compared against the screen, since all other cells are
+ * background in both.
+ *
+ * @param fd File descriptor to write to, usually STDOUT_FILENO
+ * @param context The context whose frameBuffer is sent; its drawn rectangle
+ *                (see getRendererDrawnRect()) bounds the cells compared
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on invalid
+ *         arguments, before initializeRenderer() or on a write error
+ *
+ * @note Bypasses stdio: flush stdout before mixing it with presentFrame()
+ * @note Encodes into the context's arena (see getRendererArena()), so all
+ *       presentation must stop before cleanupRenderer()
+ * @note The terminal is one per process: presenting a different context
+ *       than last time redraws in full
+ * @note A write error, a change of dimensions or resetPresentation() makes
+ *       the next frame clear the screen and redraw in full
+ */
+int presentFrame(int fd, const RenderContext* context);
+
+/**
+ * @brief Forget the last presented frame so the next one clears the screen and is sent in full
+ *
+ * Call after anything else has drawn on the terminal or the terminal was
+ * resized. Safe to call from any thread, including while a present thread runs.
+ */
+void resetPresentation(void);
+
+/**
+ * @brief Start a thread that presents frames handed over by submitFrame()
+ *
+ * Decouples terminal output from rendering: while the present thread writes
+ * frame N, the caller renders frame N+1. Frames travel through a lock-free
+ * triple buffer of preallocated frames: one slot is being filled, one being
+ * written and one published. A submitted frame replaces a published one the
+ * present thread has not reached yet, so the newest frame always wins and
+ * the renderer never blocks.
+ *
+ * @param fd File descriptor the present thread writes to
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if the thread
+ *         cannot be started (frames can still be sent with presentFrame())
+ *
+ * @note While the thread runs, presentFrame() must not be called directly
+ */
+int startPresenter(int fd);
+
+/**
+ * @brief Hand a frame to the present thread
+ *
+ * Copies the frame into the render thread's slot and publishes it in place
+ * of any frame not presented yet; never waits for the terminal.
+ *
+ * @param context The context whose frameBuffer is queued, as for presentFrame()
+ * @return ALLOCATION_SUCCESS if the frame was published,
+ *         ALLOCATION_FAILURE on invalid arguments, when no present thread is
+ *         running, or after the present thread failed to write
+ *
+ * @note Must always be called from the same thread
+ */
+int submitFrame(const RenderContext* context);
+
+/**
+ * @brief Present the newest queued frame and join the present thread
+ *
+ * @note Safe to call multiple times or when no present thread was started
+ */
+void stopPresenter(void);
+
+/**
+ * @brief Open an fd's file for non-blocking writes by presentFrameNonBlocking()
+ *
+ * The file is reopened (through /proc/self/fd, or ttyname() for a
+ * terminal) with O_NONBLOCK on a description of its own, so fd itself and
+ * any fd sharing its description, such as stdin and stderr on a terminal,
+ * stay blocking.
+ *
+ * @param fd File descriptor to write to, usually STDOUT_FILENO
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if the file
+ *         cannot be reopened
+ */
+int startNonBlockingOutput(int fd);
+
+/**
+ * @brief Present a frame without ever waiting for the terminal
+ *
+ * Called once per tick. Bytes of the previous frame the fd did not accept
+ * are sent first; if some still remain, or if more than
+ * PRESENT_BACKLOG_LIMIT bytes are queued in the terminal (TIOCOUTQ), the
+ * new frame is skipped. Otherwise it is encoded like presentFrame() and
+ * written as far as the fd accepts, the rest waiting for the next call.
+ *
+ * @param context The context whose frameBuffer is sent, as for presentFrame()
+ * @return ALLOCATION_SUCCESS if the frame was sent, started or skipped,
+ *         ALLOCATION_FAILURE on invalid arguments, without
+ *         startNonBlockingOutput() or initializeRenderer(), or on a write error
+ *
+ * @note Skipped frames never reach the screen, so the next delta is still
+ *       taken against what the terminal actually shows
+ */
+int presentFrameNonBlocking(const RenderContext* context);
+
+/**
+ * @brief Send any unfinished frame and close the non-blocking descriptor
+ *
+ * @note Safe to call multiple times or without startNonBlockingOutput()
+ */
+void stopNonBlockingOutput(void);
+
+/**
+ * @brief Get the counters accumulated by all presentation paths
+ *
+ * @return Frame and byte totals since program start
+ */
+PresentStats getPresentStats(void);
+
+#endif // PRESENT_H
@@ -9,110 +9,226 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "math3d.h"
 #include "constants.h"
 
 /**
- * @brief Current display window dimensions
- * 
- * These values define the terminal display dimensions in characters.
- * They can be dynamically configured within MIN/MAX limits.
+ * @brief How the depth buffer is reset between frames
  */
-extern int windowWidth, windowHeight;
+typedef enum
+{
+    DEPTH_BUFFER_CLEARED = 0,   /**< Float zBuffer, zeroed over the last frame's drawn rectangle */
+    DEPTH_BUFFER_EPOCH,         /**< 64-bit cells tagged with a frame epoch; clearing bumps the epoch */
+    DEPTH_BUFFER_PACKED         /**< 32-bit cells holding 16-bit fixed-point inverse depth and the glyph */
+} DepthBufferMode;
 
 /**
- * @brief Current buffer size based on window dimensions
- * 
- * Calculated as windowWidth * windowHeight. Updated when window size changes.
+ * @brief Memory backing the renderer arena
  */
-extern int bufferSize;
+typedef enum
+{
+    RENDER_ARENA_PAGES = 0,             /**< Regular pages */
+    RENDER_ARENA_HUGETLB,               /**< Explicit huge pages (MAP_HUGETLB) */
+    RENDER_ARENA_TRANSPARENT_HUGE       /**< Regular mapping advised to use transparent huge pages */
+} RenderArenaBacking;
 
 /**
- * @brief Dynamically allocated depth buffer for Z-buffering
- * 
- * Stores the inverse depth (1/z) value for each pixel to determine
- * which surfaces are visible. Allocated based on current window size.
+ * @brief The single block holding all per-frame buffers of the renderer
+ *
+ * Sections start on RENDER_ARENA_ALIGNMENT boundaries and are sized for
+ * MAX_WINDOW_WIDTH x MAX_WINDOW_HEIGHT: the depth section (zBuffer and the
+ * other depth layouts), the glyph section, the presentation stage's
+ * output and previous-frame buffers, and the coarse depth tiles. The
+ * private buffers of the work-stealing threads are not part of it: they
+ * grow with the thread pool and are allocated by the scheduler on first
+ * use.
  */
-extern float* zBuffer;
+typedef struct
+{
+    void* base;                 /**< Start of the mapping, or NULL before initializeRenderer() */
+    size_t bytes;               /**< Size of the mapping */
+    RenderArenaBacking backing; /**< Pages the mapping ended up on */
+    char* frame;                /**< Glyph section, frameBuffer unless a caller buffer is bound */
+    char* output;               /**< PRESENT_OUTPUT_CAPACITY bytes for encoded terminal output */
+    char* previousFrame;        /**< One glyph per cell for the frame currently on screen */
+} RenderArena;
 
 /**
- * @brief Dynamically allocated frame buffer for display characters
- * 
- * Each element corresponds to one character position on the terminal screen.
- * Allocated based on current window size.
+ * @brief Batch of surface points submitted to the renderer in one call
+ *
+ * Points are stored as structure-of-arrays so they can be fed directly to
+ * the batched transform kernel. Either every point carries its own glyph
+ * (glyphs != NULL) or the whole batch shares a single glyph, which is the
+ * common case for a cube face.
  */
-extern char* frameBuffer;
+typedef struct
+{
+    const float* x;         /**< Object-space X coordinates */
+    const float* y;         /**< Object-space Y coordinates */
+    const float* z;         /**< Object-space Z coordinates */
+    const char* glyphs;     /**< Per-point characters, or NULL to use glyph */
+    int glyph;              /**< Character for all points when glyphs is NULL */
+    int count;              /**< Number of points in the batch */
+} SurfaceBatch;
 
 /**
- * @brief Background character used for empty screen areas
- * 
- * ASCII character code used to fill background/empty pixels in the frame buffer.
- * Typically set to space character (32) for clear background.
+ * @brief Indexed triangles whose vertices are already projected
+ *
+ * Vertices are stored as structure-of-arrays in the ScreenVertex convention
+ * (continuous screen coordinates, inverse depth 0 when behind the viewer),
+ * so a vertex shared by several triangles is projected once. Triangles wind
+ * counter-clockwise when seen from the front.
  */
-extern int backgroundChar;
+typedef struct
+{
+    const float* x;             /**< Screen-space column coordinate per vertex */
+    const float* y;             /**< Screen-space row coordinate per vertex */
+    const float* inverseDepth;  /**< Inverse depth per vertex */
+    const int* indices;         /**< Three vertex indices per triangle */
+    const char* glyphs;         /**< Per-triangle characters, or NULL to use glyph */
+    int glyph;                  /**< Character for all triangles when glyphs is NULL */
+    const int* order;           /**< Triangles to draw, in submission order, or NULL for 0..count-1 */
+    int count;                  /**< Number of triangles drawn (entries of order when set) */
+    int cullBackFaces;          /**< Skip triangles that appear clockwise on screen */
+} TriangleBatch;
 
 /**
- * @brief Distance from the viewer/camera to the cube center
- * 
- * Controls the perspective projection. Larger values create less perspective distortion,
- * smaller values create more dramatic perspective effects.
+ * @brief Projected vertex in continuous screen space
+ *
+ * Screen coordinates are not truncated: cell (column, row) covers the area
+ * [column, column + 1) x [row, row + 1). Inverse depth is kept per vertex
+ * because 1/z varies linearly across a projected planar polygon.
  */
-extern int viewerDistance;
+typedef struct
+{
+    float x;                /**< Screen-space column coordinate */
+    float y;                /**< Screen-space row coordinate */
+    float inverseDepth;     /**< Inverse depth (1/z), 0 when behind the viewer */
+} ScreenVertex;
 
 /**
- * @brief Scale factor for perspective projection calculations
- * 
- * Determines how large the projected cube appears on screen. Higher values
- * result in larger cube visualization.
+ * @brief Half-open rectangle of screen cells [x0, x1) x [y0, y1)
+ *
+ * Used to restrict rendering to part of the buffer, e.g. a tile owned by one
+ * worker thread.
  */
-extern float projectionScaleFactor;
+typedef struct
+{
+    int x0;     /**< First column */
+    int y0;     /**< First row */
+    int x1;     /**< One past the last column */
+    int y1;     /**< One past the last row */
+} RenderRect;
 
 /**
- * @brief Current buffer index for pixel operations
- * 
- * Temporary variable used during rendering to track the current position
- * in the frame and depth buffers. Should not be accessed directly.
+ * @brief Depth and glyph buffers plus the region of them that may be written
+ *
+ * Lets the same rendering primitives draw into a context's buffers, a single
+ * tile of them, or private per-thread buffers of identical dimensions.
  */
-extern int bufferIndex;
+typedef struct
+{
+    float* depth;           /**< Inverse depth per cell, row-major */
+    char* frame;            /**< Glyph per cell, row-major */
+    int width;              /**< Cells per row (also the row stride) */
+    int height;             /**< Number of rows */
+    RenderRect clip;        /**< Cells that may be written */
+    uint64_t* depthKeys;    /**< Epoch-tagged depth per cell used instead of depth, or NULL */
+    uint32_t depthEpoch;    /**< Epoch of the current frame when depthKeys is set */
+    uint32_t* packedCells;  /**< Packed depth and glyph per cell used instead of depth and frame, or NULL */
+    float packedDepthScale; /**< Inverse depth to fixed-point factor when packedCells is set */
+} RenderTarget;
+
+/**
+ * @brief Callback rendering one screen tile
+ *
+ * @param data Caller-provided frame state, shared read-only by all tiles
+ * @param target The context's buffers clipped to the tile this invocation owns
+ */
+typedef void (*RenderTileFunction)(void* data, const RenderTarget* target);
+
+/**
+ * @brief Everything one independent renderer instance owns
+ *
+ * Buffers, projection settings and object state; defined in context.h.
+ * Every renderer and cube function takes the context it works on, so
+ * separate contexts can render concurrently from different threads.
+ */
+typedef struct RenderContext RenderContext;
 
 /**
  * @brief Initialize the rendering system with specified window dimensions
  * 
- * Allocates memory for frame and depth buffers based on the specified dimensions.
- * Must be called before any rendering operations.
+ * Maps the context's arena and carves the frame, depth and presentation
+ * buffers out of it. Must be called before any rendering operations.
  * 
+ * @param context Context set up with initializeRenderContext(); its hugePages
+ *                setting selects the arena backing
  * @param width Display width in characters (must be within MIN/MAX limits)
  * @param height Display height in characters (must be within MIN/MAX limits)
  * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
  * 
  * @note Validates input dimensions against MIN/MAX constants
  * @note Frees any existing buffers before allocating new ones
+ * @note The arena covers the largest supported window, so buffer addresses
+ *       stay fixed until cleanupRenderer()
  */
-int initializeRenderer(int width, int height);
+int initializeRenderer(RenderContext* context, int width, int height);
 
 /**
  * @brief Cleanup and free all allocated rendering resources
  * 
- * Deallocates frame and depth buffers. Should be called before program exit
+ * Unmaps the context's arena and frees the per-thread buffers the
+ * work-stealing scheduler kept for it. Should be called before program exit
  * or when changing window dimensions.
  * 
  * @note Safe to call multiple times or with NULL buffers
  */
-void cleanupRenderer(void);
+void cleanupRenderer(RenderContext* context);
+
+/**
+ * @brief Get the layout and backing of the renderer arena
+ *
+ * @param context The context owning the arena
+ * @return The arena sections, all NULL before initializeRenderer()
+ */
+RenderArena getRendererArena(const RenderContext* context);
 
 /**
  * @brief Resize the rendering buffers to new dimensions
  * 
- * Reallocates buffers with new dimensions, preserving existing content where possible.
+ * Changes the buffer dimensions and clears both buffers. The arena already
+ * covers every supported size, so resizes (e.g. while a window is dragged)
+ * never reach the allocator and never move the buffers.
  * 
+ * @param context The context to resize
  * @param newWidth New display width in characters
  * @param newHeight New display height in characters
  * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
  * 
- * @note Validates new dimensions before allocation
- * @note Falls back to previous size on allocation failure
+ * @note Validates new dimensions and fails if the renderer is not initialized
+ */
+int resizeRenderer(RenderContext* context, int newWidth, int newHeight);
+
+/**
+ * @brief Render into caller-provided glyph storage instead of the arena
+ *
+ * Makes frame the context's frameBuffer, so frames are produced in place
+ * without a copy. The storage must hold windowWidth * windowHeight bytes
+ * (MAX_WINDOW_WIDTH * MAX_WINDOW_HEIGHT to survive any resize) and stay
+ * valid while bound. Its contents are unknown to the renderer, so binding a
+ * different buffer fills it with the background once; rebinding the bound
+ * buffer is free and keeps the dirty-rectangle clears.
+ *
+ * @param context The context to render with
+ * @param frame Glyph storage to render into, or NULL for the arena's section
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if the renderer is not initialized
+ *
+ * @note The caller must not modify the cells between frames it renders
  */
-int resizeRenderer(int newWidth, int newHeight);
+int bindRendererFrameBuffer(RenderContext* context, char* frame);
 
 /**
  * @brief Initialize the frame buffer for a new frame
@@ -120,9 +236,14 @@ int resizeRenderer(int newWidth, int newHeight);
  * Clears the frame buffer by filling all positions with the background character.
  * Must be called before each frame to ensure clean rendering.
  * 
+ * @param context The context starting a frame
  * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if buffer not allocated
+ *
+ * @note Starts a new frame for getRendererDrawnRect() and getRendererDirtyRect()
+ * @note Only the rectangle drawn by the previous frame is filled; every
+ *       other cell still holds the background character
  */
-int initializeFrameBuffer(void);
+int initializeFrameBuffer(RenderContext* context);
 
 /**
  * @brief Initialize the depth buffer for Z-buffer testing
@@ -130,28 +251,248 @@ int initializeFrameBuffer(void);
  * Resets all depth buffer values to zero, preparing for depth testing during rendering.
  * Must be called before each frame to ensure proper visibility calculations.
  * 
+ * @param context The context starting a frame
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if buffer not allocated
+ *
+ * @note Only the rectangle drawn by the previous frame is zeroed
+ * @note In DEPTH_BUFFER_EPOCH mode only the frame epoch advances; the cells
+ *       are zeroed once every 2^32 - 1 frames when the epoch wraps
+ */
+int initializeDepthBuffer(RenderContext* context);
+
+/**
+ * @brief Copy the glyphs of the current frame into frameBuffer
+ *
+ * In DEPTH_BUFFER_PACKED mode the depth test writes glyphs into the packed
+ * cells only; this copies those of the drawn rectangle into frameBuffer.
+ * Call once all drawing of the frame is done. Other modes write frameBuffer
+ * directly and make this a no-op.
+ *
+ * @param context The context whose frame is complete
  * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if buffer not allocated
  */
-int initializeDepthBuffer(void);
+int resolveFrameBuffer(RenderContext* context);
 
 /**
  * @brief Project and render a 3D point to the screen buffer
  * 
- * Applies 3D rotation transformations to the input point, projects it to 2D screen
- * coordinates using perspective projection, and updates the frame buffer if the point
- * passes depth testing. Uses Z-buffering to handle surface visibility correctly.
+ * Applies the precomputed rotation transform to the input point, projects it to 2D
+ * screen coordinates using perspective projection, and updates the frame buffer if the
+ * point passes depth testing. Uses Z-buffering to handle surface visibility correctly.
  * 
  * The projection formula used is:
  * - screenX = windowWidth/2 + (projectionScaleFactor * x * 2) / z
  * - screenY = windowHeight/2 + (projectionScaleFactor * y) / z
  * 
+ * @param context The context to render into
  * @param cubePoint The 3D point on the cube surface to project and render
  * @param ch The ASCII character to draw if this point is visible (typically 'A'-'F' for cube faces)
- * @param rotation The 3D rotation angles (in radians) to apply before projection
+ * @param transform The per-frame rotation transform (see buildRotationTransform())
  * 
  * @note Points outside screen boundaries are safely ignored
  * @note Uses inverse depth (1/z) for depth comparison to avoid division by zero
  */
-void calculateForSurface(Point3D cubePoint, int ch, Rotation3D rotation);
+void calculateForSurface(RenderContext* context, Point3D cubePoint, int ch, const Transform3D* transform);
+
+/**
+ * @brief Capture the current projection settings for batched kernels
+ *
+ * Packs the context's window size, viewerDistance and projectionScaleFactor
+ * into a Projection3D matching the formula used by calculateForSurface().
+ *
+ * @param context The context to read
+ * @return The projection parameters for the current frame
+ */
+Projection3D getRendererProjection(const RenderContext* context);
+
+/**
+ * @brief Project and depth-test a whole batch of surface points
+ *
+ * Batched counterpart of calculateForSurface(). Buffer state is validated
+ * once per call, points are transformed and projected with
+ * transformProjectBatch() and the depth test runs on local copies of the
+ * renderer state, so the inner loop touches no shared memory besides the target.
+ *
+ * @param context The context whose projection is applied
+ * @param batch The points and glyphs to render
+ * @param transform The per-frame rotation transform (see buildRotationTransform())
+ * @param target Buffers and region to write, or NULL for the context's buffers
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if buffers are not
+ *         allocated or the batch is invalid
+ *
+ * @note Points outside screen boundaries or behind the viewer are ignored
+ */
+int renderSurfaceBatch(RenderContext* context, const SurfaceBatch* batch, const Transform3D* transform,
+                       const RenderTarget* target);
+
+/**
+ * @brief Project and depth-test a batch of points that are already rotated
+ *
+ * Variant of renderSurfaceBatch() for callers that generate camera-aligned
+ * coordinates themselves (e.g. incremental face traversal). Only the
+ * viewer offset and perspective projection are applied.
+ *
+ * @param context The context whose projection is applied
+ * @param batch The rotated points and glyphs to render
+ * @param target Buffers and region to write, or NULL for the context's buffers
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if buffers are not
+ *         allocated or the batch is invalid
+ */
+int renderRotatedBatch(RenderContext* context, const SurfaceBatch* batch, const RenderTarget* target);
+
+/**
+ * @brief Rotate and project a single vertex without truncating to cells
+ *
+ * @param context The context whose projection is applied
+ * @param transform The per-frame rotation transform
+ * @param point The object-space vertex
+ * @param vertex Output screen-space vertex
+ * @return 1 if the vertex lies in front of the viewer, 0 otherwise
+ */
+int projectVertex(const RenderContext* context, const Transform3D* transform, Point3D point, ScreenVertex* vertex);
+
+/**
+ * @brief Scan-convert a projected planar convex quad with depth testing
+ *
+ * Fills every cell whose center lies inside the quad. Inverse depth is
+ * interpolated from the quad's plane, so each covered cell costs exactly one
+ * depth test regardless of the quad's object-space size.
+ *
+ * @param context The context drawn into when target is NULL or its own buffers
+ * @param quad Four projected vertices in perimeter order (either winding)
+ * @param ch The ASCII character to draw for covered cells that pass the depth test
+ * @param target Buffers and region to write, or NULL for the context's buffers
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if buffers are not allocated
+ *
+ * @note Quads with any vertex behind the viewer are skipped (no near-plane clipping)
+ * @note Edge-on (zero area) quads are skipped
+ * @note A cell's interpolated depth does not depend on the clip rectangle, so
+ *       tiled rendering matches full-frame rendering exactly
+ */
+int rasterizeQuad(RenderContext* context, const ScreenVertex quad[4], int ch, const RenderTarget* target);
+
+/**
+ * @brief Scan-convert a batch of indexed triangles with depth testing
+ *
+ * Mesh counterpart of rasterizeQuad() with the same coverage and depth
+ * rules. Buffer state is validated once per call and the drawn rectangle
+ * is updated once, and triangles whose bounds miss the target's clip
+ * rectangle are rejected before any setup, so a tile pays little for the
+ * parts of a large mesh it does not cover.
+ *
+ * @param context The context drawn into when target is NULL or its own buffers
+ * @param batch The projected vertices, triangles and glyphs to render
+ * @param target Buffers and region to write, or NULL for the context's buffers
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if buffers are not
+ *         allocated or the batch is invalid
+ *
+ * @note Indices are not range-checked; they must address the vertex arrays
+ * @note Triangles with any vertex behind the viewer are skipped (no near-plane clipping)
+ */
+int rasterizeTriangles(RenderContext* context, const TriangleBatch* batch, const RenderTarget* target);
+
+/**
+ * @brief Get a target describing a context's buffers without clipping
+ *
+ * @param context The context to describe
+ * @return Target for its zBuffer/frameBuffer covering the whole window,
+ *         carrying the epoch-tagged or packed cells of the active depth mode
+ */
+RenderTarget getRendererTarget(const RenderContext* context);
+
+/**
+ * @brief Get the bounding rectangle of the cells drawn in the current frame
+ *
+ * Covers every cell of the context's zBuffer/frameBuffer written since the
+ * last initializeFrameBuffer(); all cells outside it hold the background
+ * character. Writes to other targets are not tracked until they are merged
+ * with mergeRenderTarget().
+ *
+ * @param context The context to query
+ * @return The drawn rectangle, or an empty {0, 0, 0, 0} rectangle if nothing was drawn
+ */
+RenderRect getRendererDrawnRect(const RenderContext* context);
+
+/**
+ * @brief Get the cells that may differ from the previous frame
+ *
+ * Union of the previous and the current frame's drawn rectangles: the only
+ * part of the frame that has to be cleared and presented again.
+ *
+ * @param context The context to query
+ * @return The dirty rectangle, or an empty {0, 0, 0, 0} rectangle if neither frame drew anything
+ */
+RenderRect getRendererDirtyRect(const RenderContext* context);
+
+/**
+ * @brief Refresh the coarse depth tiles overlapping a rectangle
+ *
+ * The coarse depth buffer is the hierarchical-Z level over the depth
+ * buffer: each COARSE_DEPTH_TILE x COARSE_DEPTH_TILE tile holds the
+ * farthest (smallest) inverse depth of its cells, whatever the depth
+ * layout. initializeDepthBuffer() resets it; afterwards it is only as
+ * current as the last call here, which is always safe, since depths only
+ * grow during a frame and older tile values merely occlude less.
+ *
+ * @param context The context whose depth buffer to summarize
+ * @param rect Cells drawn since the tiles were last refreshed
+ *
+ * @note Must not run while other threads write the depth buffer
+ */
+void updateCoarseDepth(RenderContext* context, RenderRect rect);
+
+/**
+ * @brief Test whether geometry can no longer show anywhere in a rectangle
+ *
+ * True when every coarse tile overlapping rect is already covered by
+ * samples at least as near as nearestInverseDepth, so any sample of the
+ * geometry would fail the depth test. Lets whole objects be skipped
+ * before any per-vertex or per-sample work; submitting them front to back
+ * makes this succeed as early as possible.
+ *
+ * @param context The context to test against
+ * @param rect Cells the geometry may cover
+ * @param nearestInverseDepth Inverse depth of the geometry's nearest point
+ * @return Non-zero if the geometry is hidden (or rect is empty), 0 otherwise
+ */
+int isRectOccluded(const RenderContext* context, RenderRect rect, float nearestInverseDepth);
+
+/**
+ * @brief Depth-merge cells of a private buffer into a context's buffers
+ *
+ * Each cell of source in [begin, end) replaces the context's cell when its
+ * inverse depth is larger, or equal with a smaller glyph, honouring the
+ * depth buffer mode. Cells never written in the source hold depth 0 and
+ * never win.
+ *
+ * @param context The context merged into
+ * @param source Buffers with the context's dimensions: depth and frame, or
+ *               packedCells when the context uses packed cells (no depthKeys)
+ * @param begin First cell index to merge
+ * @param end One past the last cell index to merge
+ *
+ * @note Disjoint ranges may be merged from different threads concurrently
+ */
+void mergeRenderTarget(RenderContext* context, const RenderTarget* source, int begin, int end);
+
+/**
+ * @brief Render a frame as screen tiles on the worker pool
+ *
+ * Splits the buffer into RENDER_TILE_WIDTH x RENDER_TILE_HEIGHT tiles that
+ * worker threads claim dynamically. Every tile is rendered by exactly one
+ * thread, which owns that slice of zBuffer and frameBuffer, so the depth test
+ * needs no locking. With a single-thread pool the function is called once
+ * with the whole buffer.
+ *
+ * @param context The context to render into
+ * @param function Callback rendering one tile
+ * @param data Frame state passed to every callback (must be read-only)
+ *
+ * @note Output is identical to a single-threaded render as long as the
+ *       callback's per-cell results do not depend on the tile bounds
+ * @note Contexts rendering from several threads share the pool's workers
+ *       (see runThreadPool())
+ */
+void renderTiled(RenderContext* context, RenderTileFunction function, void* data);
 
 #endif // RENDERER_H
\ No newline at end of file
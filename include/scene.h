@@ -0,0 +1,184 @@
+/**
+ * @file scene.h
+ * @author D. Heger
+ * @brief Instanced scenes of one mesh with grid-accelerated frustum culling
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <stddef.h>
+#include "math3d.h"
+#include "renderer.h"
+#include "mesh.h"
+
+/**
+ * @brief One placed copy of the scene's mesh
+ *
+ * A mesh point p lands at position + scale * R(rotation + spin) * p, where
+ * spin is the scene-wide rotation passed to drawScene(). The view looks
+ * along +z at the origin, like the cube's.
+ */
+typedef struct
+{
+    Point3D position;       /**< World-space center of the instance */
+    Rotation3D rotation;    /**< Orientation, added to the scene-wide spin */
+    float scale;            /**< Uniform scale of the mesh (positive) */
+} SceneInstance;
+
+/**
+ * @brief Culling counters of the most recent drawScene() call
+ */
+typedef struct
+{
+    int cellsTested;        /**< Occupied grid cells tested against the view frustum */
+    int cellsCulled;        /**< Grid cells rejected as a whole */
+    int instancesTested;    /**< Instances tested one by one (in cells straddling the frustum) */
+    int instancesCulled;    /**< Instances rejected, with their cells or one by one */
+    int instancesOccluded;  /**< Instances in view but hidden behind nearer ones */
+    int instancesDrawn;     /**< Instances transformed and rasterized */
+} SceneStats;
+
+/**
+ * @brief An instance that passed frustum culling, queued nearest first
+ */
+typedef struct
+{
+    float nearestDepth;     /**< Inverse depth of the nearest point of its bounding sphere */
+    int instance;           /**< Index into Scene::instances */
+    RenderRect bounds;      /**< Cells its bounding sphere can project to */
+} SceneDrawItem;
+
+/**
+ * @brief A list of instances sharing one mesh, and their spatial index
+ *
+ * Instances are bucketed into a uniform grid over their X/Y positions.
+ * Each frame, whole cells outside the view frustum are rejected with one
+ * box test, so the cost of culling follows the occupied cells near the
+ * window's edges rather than the instance count, and culled instances cost
+ * no per-vertex work at all.
+ */
+typedef struct
+{
+    const Mesh* mesh;               /**< Shared geometry; not owned, only read */
+    float meshRadius;               /**< Largest distance of a mesh vertex from the origin */
+
+    /**
+     * Skip instances hidden behind nearer ones. Instances are drawn front
+     * to back in batches of SCENE_BATCH_INSTANCES; with this set, each batch
+     * is tested against the coarse depth tiles the batches before it left
+     * (see isRectOccluded()). On by default; output does not depend on it.
+     */
+    int occlusionCulling;
+
+    SceneInstance* instances;       /**< The instances; call updateSceneIndex() after moving any */
+    int instanceCount;              /**< Number of instances */
+    int instanceCapacity;           /**< Instances allocated */
+
+    /* Spatial index built by updateSceneIndex() */
+
+    int indexStale;                 /**< Instances were added or moved since the last build */
+    int gridColumns;                /**< Grid cells along X */
+    int gridRows;                   /**< Grid cells along Y */
+    float gridOriginX;              /**< Smallest instance X */
+    float gridOriginY;              /**< Smallest instance Y */
+    float gridCellsPerUnitX;        /**< Grid columns per world unit */
+    float gridCellsPerUnitY;        /**< Grid rows per world unit */
+    int* cellStart;                 /**< Offset of each cell's instances in cellInstances, plus an end entry */
+    int* cellInstances;             /**< Instance indices sorted by cell */
+    float* cellBounds;              /**< Min and max corner (6 floats) of each cell's instance bounds */
+    SceneDrawItem* drawQueue;       /**< Instances that passed frustum culling, nearest first */
+    void* indexBlock;               /**< The single allocation the index arrays are carved from */
+
+    /* Per-frame scratch written by drawScene(), grown on demand */
+
+    float* screenX;                 /**< Projected column per vertex of each instance in the batch */
+    float* screenY;                 /**< Projected row per vertex of each instance in the batch */
+    float* inverseDepth;            /**< Projected inverse depth per vertex of each instance in the batch */
+    char* shading;                  /**< Facing-ramp character per triangle of each instance in the batch */
+    RenderRect* screenRects;        /**< Cells each instance in the batch may cover */
+    int* batchInstances;            /**< Instance drawn from each scratch slot */
+    int scratchCapacity;            /**< Instances a batch may hold */
+    void* scratchBlock;             /**< The single allocation the scratch arrays are carved from */
+
+    SceneStats stats;               /**< Counters of the most recent drawScene() */
+} Scene;
+
+/**
+ * @brief Set up an empty scene of a mesh
+ *
+ * @param scene The scene to set up
+ * @param mesh The mesh every instance draws; must outlive the scene
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on an empty mesh
+ */
+int initializeScene(Scene* scene, const Mesh* mesh);
+
+/**
+ * @brief Append an instance
+ *
+ * @param scene The scene to extend
+ * @param instance The instance to copy in
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if the scene
+ *         is full (SCENE_MAX_INSTANCES) or cannot grow
+ */
+int addSceneInstance(Scene* scene, SceneInstance instance);
+
+/**
+ * @brief Fill a scene with layers of instances on square grids
+ *
+ * Instances are split evenly over layers stacked away from the viewer,
+ * each a grid centered on the Z axis, spacing units apart in every
+ * direction. They start at different rotations so they do not spin in
+ * lockstep.
+ *
+ * @param scene The scene to extend
+ * @param count Number of instances to add
+ * @param layers Number of layers (1 for a flat grid)
+ * @param spacing Distance between neighbouring instance centers
+ * @param scale Scale of every instance
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
+ */
+int layoutSceneGrid(Scene* scene, int count, int layers, float spacing, float scale);
+
+/**
+ * @brief Rebuild the spatial index after instances were added or moved
+ *
+ * Sizes the grid for about SCENE_GRID_CELL_INSTANCES instances per cell
+ * and sorts the instances into it. drawScene() calls it by itself after
+ * addSceneInstance(); callers that change positions or scales in place
+ * must call it before the next frame.
+ *
+ * @param scene The scene to index
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
+ */
+int updateSceneIndex(Scene* scene);
+
+/**
+ * @brief Render every instance inside the view
+ *
+ * Grid cells and then instances are tested against the view frustum of
+ * the context's projection and window. The survivors are sorted front to
+ * back and, with occlusionCulling, tested against the coarse depth tiles
+ * batch by batch, using only their bounding spheres. The instances still
+ * left have their vertices transformed (split across the worker pool) and
+ * their triangles rasterized as screen tiles, each tile visiting only the
+ * instances whose projection overlaps it.
+ *
+ * @param context The context to render into
+ * @param scene The scene to draw; its scratch arrays and stats are overwritten
+ * @param spin Rotation added to every instance's own
+ *
+ * @note Allocates only on the first frame and when the index is stale
+ */
+void drawScene(RenderContext* context, Scene* scene, Rotation3D spin);
+
+/**
+ * @brief Release a scene's memory (not its mesh)
+ *
+ * @param scene The scene to release; safe to call on a released scene
+ */
+void destroyScene(Scene* scene);
+
+#endif // SCENE_H
@@ -0,0 +1,71 @@
+/**
+ * @file threadpool.h
+ * @author D. Heger
+ * @brief Persistent worker thread pool for parallel rendering
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "constants.h"
+
+/**
+ * @brief Work item executed by every pool thread
+ *
+ * The same function runs once for each thread index (index 0 on the
+ * caller), which distributes work itself, e.g. by claiming tiles from a
+ * shared counter. Indices usually run in parallel, but may run one after
+ * another on the same thread, so no index may wait for another.
+ *
+ * @param context Caller-provided shared state
+ * @param threadIndex Index of this invocation, 0 runs on the calling thread
+ * @param threadCount Total number of threads executing the task
+ */
+typedef void (*ThreadPoolTask)(void* context, int threadIndex, int threadCount);
+
+/**
+ * @brief Start the persistent worker pool
+ *
+ * Spawns threadCount - 1 worker threads; the calling thread participates as
+ * thread 0 in every runThreadPool() call. Workers sleep on a condition
+ * variable between frames. Any previously started pool is stopped first.
+ *
+ * @param threadCount Total threads including the caller (1..MAX_RENDER_THREADS),
+ *                    or 0 to use one thread per online CPU
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
+ *
+ * @note On failure the pool falls back to single-threaded execution
+ */
+int initializeThreadPool(int threadCount);
+
+/**
+ * @brief Stop and join all worker threads
+ *
+ * @note Safe to call multiple times or when no pool was started
+ */
+void cleanupThreadPool(void);
+
+/**
+ * @brief Get the number of threads that execute each task
+ *
+ * @return Total thread count including the caller (at least 1)
+ */
+int getThreadPoolSize(void);
+
+/**
+ * @brief Run a task once for every thread index and wait for all of them
+ *
+ * @param task The function executed once per thread index
+ * @param context Shared state passed to every invocation
+ *
+ * @note Several threads may run tasks at once: their runs queue up and
+ *       share the workers, and each caller runs the indices of its own task
+ *       that no worker has claimed yet. The pool must not be started or
+ *       stopped while another thread may call runThreadPool()
+ * @note Not reentrant: tasks must not call runThreadPool() themselves
+ */
+void runThreadPool(ThreadPoolTask task, void* context);
+
+#endif // THREADPOOL_H
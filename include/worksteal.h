@@ -0,0 +1,70 @@
+/**
+ * @file worksteal.h
+ * @author D. Heger
+ * @brief Work-stealing scheduler with per-thread depth buffers
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#ifndef WORKSTEAL_H
+#define WORKSTEAL_H
+
+#include "constants.h"
+#include "renderer.h"
+
+/**
+ * @brief Callback rendering one work item
+ *
+ * @param data Caller-provided frame state, shared read-only by all items
+ * @param item Index of the item in [0, itemCount)
+ * @param target The executing thread's buffers, unclipped
+ */
+typedef void (*RenderItemFunction)(void* data, int item, const RenderTarget* target);
+
+/**
+ * @brief Scheduling counters of the most recent renderWorkStealing() call
+ */
+typedef struct
+{
+    int items;      /**< Work items submitted */
+    int steals;     /**< Items executed by a thread other than their owner */
+} WorkStealStats;
+
+/**
+ * @brief Render a frame as independent items scheduled by work stealing
+ *
+ * Items are dealt to the pool threads in contiguous ranges. Each thread
+ * pops items from the front of its own deque and, once empty, steals from
+ * the back of the others. Every thread renders into private depth and glyph
+ * buffers; a parallel min-depth reduction then merges them into the
+ * context's zBuffer/frameBuffer, which must already be cleared for the frame.
+ *
+ * @param context The context to render into; it keeps the private buffers
+ * @param itemCount Number of items to render
+ * @param function Callback executed once per item
+ * @param data Shared state passed to every invocation
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if the renderer
+ *         is not initialized or the per-thread buffers cannot be allocated
+ *
+ * @note With a single pool thread items render directly into the context's buffers
+ */
+int renderWorkStealing(RenderContext* context, int itemCount, RenderItemFunction function, void* data);
+
+/**
+ * @brief Get the scheduling counters of the most recent frame
+ *
+ * @param context The context that rendered the frame
+ * @return Items submitted and items stolen
+ */
+WorkStealStats getWorkStealStats(const RenderContext* context);
+
+/**
+ * @brief Free the per-thread buffers of a context
+ *
+ * @param context The context owning the buffers
+ *
+ * @note Safe to call multiple times
+ */
+void cleanupWorkStealing(RenderContext* context);
+
+#endif // WORKSTEAL_H
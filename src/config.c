@@ -0,0 +1,107 @@
+/**
+ * @file config.c
+ * @author D. Heger
+ * @brief Runtime configuration implementation
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+
+/**
+ * @brief Read an integer environment variable within [minimum, maximum]
+ */
+static int parseEnvInt(const char* name, int defaultValue, int minimum, int maximum)
+{
+    const char* envValue = getenv(name);
+    if (envValue == NULL || envValue[0] == '\0') {
+        return defaultValue;
+    }
+
+    char* endPtr = NULL;
+    errno = 0;
+    long parsed = strtol(envValue, &endPtr, 10);
+
+    if (errno != 0 || endPtr == envValue || *endPtr != '\0' || parsed < minimum || parsed > maximum) {
+        fprintf(stderr, "Warning: invalid %s value '%s' (expected %d..%d). Using %d.\n",
+                name, envValue, minimum, maximum, defaultValue);
+        return defaultValue;
+    }
+
+    return (int)parsed;
+}
+
+/**
+ * @brief Read an environment variable naming one of choices
+ *
+ * @return Index of the matching choice, or defaultIndex
+ */
+static int parseEnvChoice(const char* name, const char* const choices[], int choiceCount, int defaultIndex)
+{
+    const char* envValue = getenv(name);
+    if (envValue == NULL || envValue[0] == '\0') {
+        return defaultIndex;
+    }
+
+    for (int i = 0; i < choiceCount; i++) {
+        if (strcmp(envValue, choices[i]) == 0) {
+            return i;
+        }
+    }
+
+    fprintf(stderr, "Warning: invalid %s value '%s'. Using %s.\n", name, envValue, choices[defaultIndex]);
+    return defaultIndex;
+}
+
+RuntimeConfig loadRuntimeConfig(void)
+{
+    /* Indexed by PresentOutputMode */
+    static const char* const outputModes[] = {"threaded", "nonblocking", "blocking"};
+
+    RuntimeConfig config;
+    config.renderThreads = parseEnvInt(ENV_RENDER_THREADS, DEFAULT_RENDER_THREADS, 0, MAX_RENDER_THREADS);
+    config.outputMode = (PresentOutputMode)parseEnvChoice(ENV_OUTPUT_MODE, outputModes, 3, PRESENT_OUTPUT_THREADED);
+    config.targetFps = parseEnvInt(ENV_TARGET_FPS, 0, 0, MAX_TARGET_FPS);
+    config.hugePages = parseEnvInt(ENV_HUGE_PAGES, 0, 0, 1);
+
+    const char* meshPath = getenv(ENV_MESH);
+    config.meshPath = meshPath != NULL && meshPath[0] != '\0' ? meshPath : NULL;
+    config.instanceCount = parseEnvInt(ENV_INSTANCES, 0, 0, SCENE_MAX_INSTANCES);
+    config.instanceLayers = parseEnvInt(ENV_INSTANCE_LAYERS, 1, 1, SCENE_MAX_INSTANCES);
+    config.occlusionCulling = parseEnvInt(ENV_OCCLUSION, 1, 0, 1);
+    return config;
+}
+
+int loadConfiguredMesh(const RuntimeConfig* config, const CubeObject* cube, Mesh* mesh)
+{
+    if (config->meshPath == NULL || strcmp(config->meshPath, MESH_BUILTIN_CUBE) == 0) {
+        return createCubeMesh(mesh, cube);
+    }
+
+    if (loadMesh(mesh, config->meshPath) != ALLOCATION_SUCCESS) {
+        return ALLOCATION_FAILURE;
+    }
+    fitMesh(mesh, cube->width);
+    return ALLOCATION_SUCCESS;
+}
+
+int loadConfiguredScene(const RuntimeConfig* config, const CubeObject* cube, const Mesh* mesh, Scene* scene)
+{
+    if (initializeScene(scene, mesh) != ALLOCATION_SUCCESS) {
+        return ALLOCATION_FAILURE;
+    }
+    scene->occlusionCulling = config->occlusionCulling;
+
+    const float spacing = SCENE_INSTANCE_SPACING * cube->width * SCENE_INSTANCE_SCALE;
+    if (layoutSceneGrid(scene, config->instanceCount, config->instanceLayers, spacing,
+                        SCENE_INSTANCE_SCALE) != ALLOCATION_SUCCESS ||
+        updateSceneIndex(scene) != ALLOCATION_SUCCESS) {
+        destroyScene(scene);
+        return ALLOCATION_FAILURE;
+    }
+    return ALLOCATION_SUCCESS;
+}
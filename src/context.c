@@ -0,0 +1,33 @@
+/**
+ * @file context.c
+ * @author D. Heger
+ * @brief Render context setup
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#include <string.h>
+#include "context.h"
+
+void initializeRenderContext(RenderContext* context)
+{
+    if (context == NULL) {
+        return;
+    }
+
+    /* Zero buffers, counters and bookkeeping; initializeRenderer() sets the rest */
+    memset(context, 0, sizeof(*context));
+
+    context->backgroundChar = BACKGROUND_CHARACTER;
+    context->viewerDistance = DEFAULT_VIEWER_DISTANCE;
+    context->projectionScaleFactor = DEFAULT_PROJECTION_SCALE;
+    context->depthBufferMode = DEPTH_BUFFER_CLEARED;
+    context->hugePages = 0;
+    context->windowWidth = DEFAULT_WINDOW_WIDTH;
+    context->windowHeight = DEFAULT_WINDOW_HEIGHT;
+    context->arena.backing = RENDER_ARENA_PAGES;
+    context->activeDepthMode = DEPTH_BUFFER_CLEARED;
+    context->depthStorageStale = 1;
+
+    initializeCubeObject(&context->cube);
+}
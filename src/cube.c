@@ -6,50 +6,645 @@
  * @date 2025-08-05
  */
 
+#include <limits.h>
+#include <stddef.h>
+#include <math.h>
 #include "cube.h"
+#include "context.h"
 #include "renderer.h"
 #include "math3d.h"
+#include "worksteal.h"
 
-/* Global cube state variables */
-float cubeWidth = DEFAULT_CUBE_WIDTH;
-float cubeIncrementStep = CUBE_INCREMENT_STEP;
-Rotation3D rotationAngles = {0.0f, 0.0f, 0.0f};
+/**
+ * @brief Parametric description of one cube face
+ *
+ * A face sample at row parameter u and column parameter v is located at
+ * u * uAxis + v * vAxis + width * normal.
+ */
+typedef struct
+{
+    int glyph;          /**< Character drawn for this face */
+    Point3D uAxis;      /**< Direction of the row (outer loop) parameter */
+    Point3D vAxis;      /**< Direction of the column (inner loop) parameter */
+    Point3D normal;     /**< Outward unit normal of the face */
+} CubeFace;
 
-void drawCube(Rotation3D rotation)
+static const CubeFace cubeFaces[] = {
+    {'A', { 1.0f, 0.0f,  0.0f}, {0.0f, 1.0f,  0.0f}, { 0.0f,  0.0f, -1.0f}},   /* Front  (z = -width) */
+    {'B', { 0.0f, 0.0f,  1.0f}, {0.0f, 1.0f,  0.0f}, { 1.0f,  0.0f,  0.0f}},   /* Right  (x = +width) */
+    {'C', { 0.0f, 0.0f, -1.0f}, {0.0f, 1.0f,  0.0f}, {-1.0f,  0.0f,  0.0f}},   /* Left   (x = -width) */
+    {'D', {-1.0f, 0.0f,  0.0f}, {0.0f, 1.0f,  0.0f}, { 0.0f,  0.0f,  1.0f}},   /* Back   (z = +width) */
+    {'E', { 1.0f, 0.0f,  0.0f}, {0.0f, 0.0f, -1.0f}, { 0.0f, -1.0f,  0.0f}},   /* Bottom (y = -width) */
+    {'F', { 1.0f, 0.0f,  0.0f}, {0.0f, 0.0f,  1.0f}, { 0.0f,  1.0f,  0.0f}},   /* Top    (y = +width) */
+};
+
+#define CUBE_FACE_COUNT ((int)(sizeof(cubeFaces) / sizeof(cubeFaces[0])))
+
+/**
+ * @brief Per-frame cube state shared read-only by all render tiles
+ */
+typedef struct
 {
-    /* Validate cube parameters */
-    if (cubeWidth <= 0.0f || cubeIncrementStep <= 0.0f) {
-        return; /* Invalid cube dimensions */
+    RenderContext* context;                     /**< Context rendered into */
+    const CubeObject* cube;                     /**< Settings of the cube drawn */
+    Transform3D transform;                      /**< Rotation for this frame */
+    Projection3D projection;                    /**< Projection of the context for this frame */
+    long edgeSamples;                           /**< Samples per face edge (sampled mode) */
+    int visible[CUBE_FACE_COUNT];               /**< Back-face classification result */
+    ScreenVertex quads[CUBE_FACE_COUNT][4];     /**< Projected face corners */
+    RenderRect faceBounds[CUBE_FACE_COUNT];     /**< Conservative screen bounds per face */
+    int firstItem[CUBE_FACE_COUNT + 1];         /**< Work-stealing items per face, as prefix sums */
+} CubeFrame;
+
+/**
+ * @brief A face's sample grid in rotated space
+ *
+ * Sample (row, column) of the face sits at origin + row * stepU + column * stepV.
+ */
+typedef struct
+{
+    Point3D origin;     /**< First sample of the face */
+    Point3D stepU;      /**< Offset from one row to the next */
+    Point3D stepV;      /**< Offset from one column to the next */
+} FaceLattice;
+
+/**
+ * @brief Rotate a face's first sample and its two step vectors
+ */
+static FaceLattice buildFaceLattice(const CubeFrame* frame, const CubeFace* face)
+{
+    const Transform3D* transform = &frame->transform;
+    const float cubeWidth = frame->cube->width;
+    const float cubeIncrementStep = frame->cube->incrementStep;
+
+    FaceLattice lattice;
+    lattice.origin = transformPoint(transform, (Point3D){
+        (face->normal.x - face->uAxis.x - face->vAxis.x) * cubeWidth,
+        (face->normal.y - face->uAxis.y - face->vAxis.y) * cubeWidth,
+        (face->normal.z - face->uAxis.z - face->vAxis.z) * cubeWidth
+    });
+    lattice.stepU = transformPoint(transform, (Point3D){
+        face->uAxis.x * cubeIncrementStep, face->uAxis.y * cubeIncrementStep, face->uAxis.z * cubeIncrementStep
+    });
+    lattice.stepV = transformPoint(transform, (Point3D){
+        face->vAxis.x * cubeIncrementStep, face->vAxis.y * cubeIncrementStep, face->vAxis.z * cubeIncrementStep
+    });
+    return lattice;
+}
+
+/**
+ * @brief Exact sample position origin + steps * step, used to bound drift
+ */
+static Point3D anchorPoint(Point3D origin, Point3D step, long steps)
+{
+    const float scale = (float)steps;
+    return (Point3D){origin.x + step.x * scale, origin.y + step.y * scale, origin.z + step.z * scale};
+}
+
+/**
+ * @brief Narrow a parameter range [*low, *high] to the solutions of a * t >= b
+ */
+static void clipParameterRange(float a, float b, float* low, float* high)
+{
+    if (a > 0.0f) {
+        *low = fmaxf(*low, b / a);
+    } else if (a < 0.0f) {
+        *high = fminf(*high, b / a);
+    } else if (b > 0.0f) {
+        *high = -INFINITY;
+    }
+}
+
+/**
+ * @brief Columns of one face row whose samples can land in a region
+ *
+ * Along a row, a sample's screen x and y are ratios of linear functions of
+ * its column, so each side of the region (widened by a cell to cover
+ * truncation) bounds the column by one linear inequality. A column of
+ * margin at each end covers rounding and the drift of accumulated samples.
+ *
+ * @param frame The frame being drawn
+ * @param rowStart First sample of the row, rotated
+ * @param stepV Offset from one column to the next, rotated
+ * @param region The cells to reach
+ * @param columnBegin Receives the first column to generate
+ * @param columnEnd Receives one past the last column to generate
+ * @return 1 if any column can reach the region, 0 if the row can be skipped
+ */
+static int findRegionColumns(const CubeFrame* frame, Point3D rowStart, Point3D stepV, const RenderRect* region,
+                             long* columnBegin, long* columnEnd)
+{
+    const Projection3D* projection = &frame->projection;
+    const float depth = rowStart.z + projection->viewerDistance;
+    const float left = (float)(region->x0 - 1) - projection->centerX;
+    const float right = (float)(region->x1 + 1) - projection->centerX;
+    const float top = (float)(region->y0 - 1) - projection->centerY;
+    const float bottom = (float)(region->y1 + 1) - projection->centerY;
+    float low = 0.0f;
+    float high = (float)(frame->edgeSamples - 1);
+
+    /* In front of the viewer, then scale * position against side * depth */
+    clipParameterRange(stepV.z, -depth, &low, &high);
+    clipParameterRange(projection->scaleX * stepV.x - left * stepV.z,
+                       left * depth - projection->scaleX * rowStart.x, &low, &high);
+    clipParameterRange(right * stepV.z - projection->scaleX * stepV.x,
+                       projection->scaleX * rowStart.x - right * depth, &low, &high);
+    clipParameterRange(projection->scaleY * stepV.y - top * stepV.z,
+                       top * depth - projection->scaleY * rowStart.y, &low, &high);
+    clipParameterRange(bottom * stepV.z - projection->scaleY * stepV.y,
+                       projection->scaleY * rowStart.y - bottom * depth, &low, &high);
+
+    if (!(low <= high)) {
+        return 0;
     }
+    *columnBegin = (long)low > 0 ? (long)low - 1 : 0;
+    *columnEnd = (long)high + 2 < frame->edgeSamples ? (long)high + 2 : frame->edgeSamples;
+    return 1;
+}
+
+/**
+ * @brief Generate the samples of rows [rowBegin, rowEnd) of one face and submit them in batches
+ *
+ * With a region, only the columns of each row that can reach it are generated.
+ */
+static void drawCubeFace(const CubeFrame* frame, const CubeFace* face, long rowBegin, long rowEnd,
+                         const RenderRect* region, const RenderTarget* target)
+{
+    const float cubeWidth = frame->cube->width;
+    const float cubeIncrementStep = frame->cube->incrementStep;
+    const FaceLattice lattice = buildFaceLattice(frame, face);
+
+    float x[RENDER_BATCH_SIZE];
+    float y[RENDER_BATCH_SIZE];
+    float z[RENDER_BATCH_SIZE];
+    SurfaceBatch batch = {x, y, z, NULL, face->glyph, 0};
 
-    /* Generate surface points for all six faces */
-    for (float cubeX = -cubeWidth; cubeX < cubeWidth; cubeX += cubeIncrementStep)
+    const Point3D planeOffset = {
+        face->normal.x * cubeWidth, face->normal.y * cubeWidth, face->normal.z * cubeWidth
+    };
+
+    /* u and v are accumulated exactly as in a full pass so chunks and tiles line up */
+    long row = 0;
+    for (float u = -cubeWidth; u < cubeWidth && row < rowEnd; u += cubeIncrementStep, row++)
     {
-        for (float cubeY = -cubeWidth; cubeY < cubeWidth; cubeY += cubeIncrementStep)
+        long columnBegin = 0, columnEnd = frame->edgeSamples;
+        if (row < rowBegin ||
+            (region != NULL && !findRegionColumns(frame, anchorPoint(lattice.origin, lattice.stepU, row),
+                                                  lattice.stepV, region, &columnBegin, &columnEnd))) {
+            continue;
+        }
+
+        float v = -cubeWidth;
+        for (long column = 0; column < columnEnd; column++, v += cubeIncrementStep)
         {
-            /* Front face (z = -cubeWidth) */
-            calculateForSurface((Point3D){cubeX, cubeY, -cubeWidth}, 'A', rotation);
-            
-            /* Right face (x = cubeWidth) */
-            calculateForSurface((Point3D){cubeWidth, cubeY, cubeX}, 'B', rotation);
-            
-            /* Left face (x = -cubeWidth) */
-            calculateForSurface((Point3D){-cubeWidth, cubeY, -cubeX}, 'C', rotation);
-            
-            /* Back face (z = cubeWidth) */
-            calculateForSurface((Point3D){-cubeX, cubeY, cubeWidth}, 'D', rotation);
-            
-            /* Bottom face (y = -cubeWidth) */
-            calculateForSurface((Point3D){cubeX, -cubeWidth, -cubeY}, 'E', rotation);
-            
-            /* Top face (y = cubeWidth) */
-            calculateForSurface((Point3D){cubeX, cubeWidth, cubeY}, 'F', rotation);
-        }
-    }
-}
-
-void incrementRotationAngles(void)
-{
-    rotationAngles.x += ROTATION_INCREMENT;
-    rotationAngles.y += ROTATION_INCREMENT;
+            if (column < columnBegin) {
+                continue;
+            }
+
+            x[batch.count] = u * face->uAxis.x + v * face->vAxis.x + planeOffset.x;
+            y[batch.count] = u * face->uAxis.y + v * face->vAxis.y + planeOffset.y;
+            z[batch.count] = u * face->uAxis.z + v * face->vAxis.z + planeOffset.z;
+
+            if (++batch.count == RENDER_BATCH_SIZE) {
+                renderSurfaceBatch(frame->context, &batch, &frame->transform, target);
+                batch.count = 0;
+            }
+        }
+    }
+
+    if (batch.count > 0) {
+        renderSurfaceBatch(frame->context, &batch, &frame->transform, target);
+    }
+}
+
+/**
+ * @brief Generate rows [rowBegin, rowEnd) of one face by forward differencing in rotated space
+ *
+ * Only the face origin and the two step vectors are transformed; every
+ * sample is then reached with three additions. Every reanchorInterval
+ * steps the position is recomputed from the origin to bound float drift.
+ * With a region, only the columns of each row that can reach it are
+ * generated, starting from the last re-anchor before them.
+ */
+static void drawCubeFaceIncremental(const CubeFrame* frame, const CubeFace* face, long rowBegin, long rowEnd,
+                                    const RenderRect* region, const RenderTarget* target)
+{
+    const long edgeSamples = frame->edgeSamples;
+    const FaceLattice lattice = buildFaceLattice(frame, face);
+    const Point3D origin = lattice.origin;
+    const Point3D stepU = lattice.stepU;
+    const Point3D stepV = lattice.stepV;
+
+    float x[RENDER_BATCH_SIZE];
+    float y[RENDER_BATCH_SIZE];
+    float z[RENDER_BATCH_SIZE];
+    SurfaceBatch batch = {x, y, z, NULL, face->glyph, 0};
+
+    /* Down-counters reach zero at every re-anchor step; never with re-anchoring off */
+    const long interval = frame->cube->reanchorInterval > 0 ? frame->cube->reanchorInterval : LONG_MAX;
+
+    /* Rows before rowBegin are still stepped so every chunk starts bit-identically */
+    Point3D rowStart = origin;
+    long rowsToAnchor = interval;
+    for (long row = 0; row < rowEnd; row++)
+    {
+        if (row > 0) {
+            if (--rowsToAnchor == 0) {
+                rowStart = anchorPoint(origin, stepU, row);
+                rowsToAnchor = interval;
+            } else {
+                rowStart.x += stepU.x;
+                rowStart.y += stepU.y;
+                rowStart.z += stepU.z;
+            }
+        }
+        long columnBegin = 0, columnEnd = edgeSamples;
+        if (row < rowBegin ||
+            (region != NULL && !findRegionColumns(frame, rowStart, stepV, region, &columnBegin, &columnEnd))) {
+            continue;
+        }
+
+        /* Resume from the last re-anchor so the samples stay bit-identical to a full pass */
+        const long anchorColumn = columnBegin / interval * interval;
+        Point3D sample = anchorColumn > 0 ? anchorPoint(rowStart, stepV, anchorColumn) : rowStart;
+        long columnsToAnchor = interval;
+        for (long column = anchorColumn; column < columnEnd; column++)
+        {
+            if (column > anchorColumn) {
+                if (--columnsToAnchor == 0) {
+                    sample = anchorPoint(rowStart, stepV, column);
+                    columnsToAnchor = interval;
+                } else {
+                    sample.x += stepV.x;
+                    sample.y += stepV.y;
+                    sample.z += stepV.z;
+                }
+            }
+            if (column < columnBegin) {
+                continue;
+            }
+
+            x[batch.count] = sample.x;
+            y[batch.count] = sample.y;
+            z[batch.count] = sample.z;
+
+            if (++batch.count == RENDER_BATCH_SIZE) {
+                renderRotatedBatch(frame->context, &batch, target);
+                batch.count = 0;
+            }
+        }
+    }
+
+    if (batch.count > 0) {
+        renderRotatedBatch(frame->context, &batch, target);
+    }
+}
+
+/**
+ * @brief Index of the cube corner with the given coordinate signs
+ *
+ * Corners are numbered by sign bits: bit 0 for +X, bit 1 for +Y, bit 2 for +Z.
+ */
+static int cornerIndex(Point3D direction)
+{
+    return (direction.x > 0.0f ? 1 : 0) | (direction.y > 0.0f ? 2 : 0) | (direction.z > 0.0f ? 4 : 0);
+}
+
+/**
+ * @brief Conservative screen cell bounds of a projected face
+ *
+ * Covers both the rasterizer's cell-center rule and the sampled path's
+ * truncation, with one cell of margin. Faces crossing the viewer plane get
+ * unbounded extents.
+ */
+static RenderRect projectedFaceBounds(const ScreenVertex quad[4])
+{
+    RenderRect bounds = {-1, -1, MAX_WINDOW_WIDTH + 1, MAX_WINDOW_HEIGHT + 1};
+    float minX = quad[0].x, maxX = quad[0].x, minY = quad[0].y, maxY = quad[0].y;
+
+    for (int i = 0; i < 4; i++) {
+        if (!(quad[i].inverseDepth > 0.0f)) {
+            return bounds;
+        }
+        minX = fminf(minX, quad[i].x);
+        maxX = fmaxf(maxX, quad[i].x);
+        minY = fminf(minY, quad[i].y);
+        maxY = fmaxf(maxY, quad[i].y);
+    }
+
+    /* Clamp before converting so far off-screen faces cannot overflow */
+    bounds.x0 = (int)floorf(fminf(fmaxf(minX, -1.0f), (float)MAX_WINDOW_WIDTH)) - 1;
+    bounds.y0 = (int)floorf(fminf(fmaxf(minY, -1.0f), (float)MAX_WINDOW_HEIGHT)) - 1;
+    bounds.x1 = (int)floorf(fminf(fmaxf(maxX, -1.0f), (float)MAX_WINDOW_WIDTH)) + 2;
+    bounds.y1 = (int)floorf(fminf(fmaxf(maxY, -1.0f), (float)MAX_WINDOW_HEIGHT)) + 2;
+    return bounds;
+}
+
+/**
+ * @brief Project the eight corners once and assemble every face quad
+ */
+static void projectCubeFaces(CubeFrame* frame)
+{
+    const float cubeWidth = frame->cube->width;
+    ScreenVertex corners[8];
+    for (int corner = 0; corner < 8; corner++) {
+        const Point3D point = {
+            (corner & 1) ? cubeWidth : -cubeWidth,
+            (corner & 2) ? cubeWidth : -cubeWidth,
+            (corner & 4) ? cubeWidth : -cubeWidth
+        };
+        projectVertex(frame->context, &frame->transform, point, &corners[corner]);
+    }
+
+    /* Walk each face's (u, v) corners in perimeter order */
+    static const float uSigns[4] = {-1.0f, 1.0f, 1.0f, -1.0f};
+    static const float vSigns[4] = {-1.0f, -1.0f, 1.0f, 1.0f};
+
+    for (int face = 0; face < CUBE_FACE_COUNT; face++) {
+        const CubeFace* cubeFace = &cubeFaces[face];
+
+        for (int i = 0; i < 4; i++) {
+            const Point3D direction = {
+                uSigns[i] * cubeFace->uAxis.x + vSigns[i] * cubeFace->vAxis.x + cubeFace->normal.x,
+                uSigns[i] * cubeFace->uAxis.y + vSigns[i] * cubeFace->vAxis.y + cubeFace->normal.y,
+                uSigns[i] * cubeFace->uAxis.z + vSigns[i] * cubeFace->vAxis.z + cubeFace->normal.z
+            };
+            frame->quads[face][i] = corners[cornerIndex(direction)];
+        }
+        frame->faceBounds[face] = projectedFaceBounds(frame->quads[face]);
+    }
+}
+
+/**
+ * @brief Render every visible face that overlaps one screen region
+ *
+ * Used as the tile callback of renderTiled(); reads the frame state only.
+ */
+static void drawCubeRegion(void* data, const RenderTarget* target)
+{
+    const CubeFrame* frame = (const CubeFrame*)data;
+    const RenderRect* region = &target->clip;
+
+    for (int face = 0; face < CUBE_FACE_COUNT; face++) {
+        const RenderRect* bounds = &frame->faceBounds[face];
+        if (!frame->visible[face] ||
+            bounds->x1 <= region->x0 || bounds->x0 >= region->x1 ||
+            bounds->y1 <= region->y0 || bounds->y0 >= region->y1) {
+            continue;
+        }
+
+        /* Sampled faces only generate the rows and runs that reach a tile they straddle */
+        const int contained = bounds->x0 >= region->x0 && bounds->x1 <= region->x1 &&
+                              bounds->y0 >= region->y0 && bounds->y1 <= region->y1;
+        const RenderRect* sampleRegion = contained ? NULL : region;
+
+        if (frame->cube->renderMode == CUBE_RENDER_RASTERIZED) {
+            rasterizeQuad(frame->context, frame->quads[face], cubeFaces[face].glyph, target);
+        } else if (frame->cube->traversalMode == CUBE_TRAVERSAL_INCREMENTAL) {
+            drawCubeFaceIncremental(frame, &cubeFaces[face], 0L, frame->edgeSamples, sampleRegion, target);
+        } else {
+            drawCubeFace(frame, &cubeFaces[face], 0L, frame->edgeSamples, sampleRegion, target);
+        }
+    }
+}
+
+/**
+ * @brief First screen row and row count a face may cover
+ */
+static void faceScreenRows(const CubeFrame* frame, int face, int* firstRow, int* rowCount)
+{
+    const RenderRect* bounds = &frame->faceBounds[face];
+    const int windowHeight = frame->context->windowHeight;
+    const int top = bounds->y0 > 0 ? bounds->y0 : 0;
+    const int bottom = bounds->y1 < windowHeight ? bounds->y1 : windowHeight;
+    *firstRow = top;
+    *rowCount = bottom > top ? bottom - top : 0;
+}
+
+/**
+ * @brief Split every visible face into chunks of RENDER_STEAL_CHUNK_ROWS rows
+ *
+ * Sampled mode chunks the face's sample rows, rasterized mode the screen
+ * rows its bounds cover. The item ranges are stored as prefix sums.
+ */
+static void planCubeItems(CubeFrame* frame)
+{
+    frame->firstItem[0] = 0;
+    for (int face = 0; face < CUBE_FACE_COUNT; face++) {
+        long rows = 0;
+        if (frame->visible[face]) {
+            if (frame->cube->renderMode == CUBE_RENDER_RASTERIZED) {
+                int firstRow, rowCount;
+                faceScreenRows(frame, face, &firstRow, &rowCount);
+                rows = rowCount;
+            } else {
+                rows = frame->edgeSamples;
+            }
+        }
+        frame->firstItem[face + 1] = frame->firstItem[face] +
+                                     (int)((rows + RENDER_STEAL_CHUNK_ROWS - 1) / RENDER_STEAL_CHUNK_ROWS);
+    }
+}
+
+/**
+ * @brief Render one chunk of face rows into the executing thread's buffers
+ *
+ * Used as the item callback of renderWorkStealing(); reads the frame state only.
+ */
+static void drawCubeItem(void* data, int item, const RenderTarget* target)
+{
+    const CubeFrame* frame = (const CubeFrame*)data;
+
+    int face = 0;
+    while (item >= frame->firstItem[face + 1]) {
+        face++;
+    }
+    const long rowBegin = (long)(item - frame->firstItem[face]) * RENDER_STEAL_CHUNK_ROWS;
+
+    if (frame->cube->renderMode == CUBE_RENDER_RASTERIZED) {
+        int firstRow, rowCount;
+        faceScreenRows(frame, face, &firstRow, &rowCount);
+
+        RenderTarget band = *target;
+        band.clip.y0 = firstRow + (int)rowBegin;
+        band.clip.y1 = band.clip.y0 + RENDER_STEAL_CHUNK_ROWS < firstRow + rowCount
+                           ? band.clip.y0 + RENDER_STEAL_CHUNK_ROWS
+                           : firstRow + rowCount;
+        rasterizeQuad(frame->context, frame->quads[face], cubeFaces[face].glyph, &band);
+        return;
+    }
+
+    const long rowEnd = rowBegin + RENDER_STEAL_CHUNK_ROWS < frame->edgeSamples
+                            ? rowBegin + RENDER_STEAL_CHUNK_ROWS
+                            : frame->edgeSamples;
+    if (frame->cube->traversalMode == CUBE_TRAVERSAL_INCREMENTAL) {
+        drawCubeFaceIncremental(frame, &cubeFaces[face], rowBegin, rowEnd, NULL, target);
+    } else {
+        drawCubeFace(frame, &cubeFaces[face], rowBegin, rowEnd, NULL, target);
+    }
+}
+
+/**
+ * @brief Decide whether a face can be seen from the viewer at the origin
+ *
+ * The face center is width * normal, so after rotation and the viewer
+ * offset it sits at width * n' + (0, 0, viewerDistance). The face is
+ * front-facing when its rotated normal n' points back toward the viewer.
+ */
+static int isFaceVisible(const CubeFrame* frame, const CubeFace* face)
+{
+    const float cubeWidth = frame->cube->width;
+    const Point3D normal = transformPoint(&frame->transform, face->normal);
+    const Point3D center = {
+        normal.x * cubeWidth, normal.y * cubeWidth, normal.z * cubeWidth + (float)frame->context->viewerDistance
+    };
+    return normal.x * center.x + normal.y * center.y + normal.z * center.z < 0.0f;
+}
+
+/**
+ * @brief Number of samples the sampled loops generate along one face edge
+ */
+static long countEdgeSamples(const CubeObject* cube)
+{
+    long count = 0;
+    for (float u = -cube->width; u < cube->width; u += cube->incrementStep) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Classify all faces for this frame and record the culling counters
+ *
+ * @param frame The frame whose transform and edge samples are set; receives
+ *              the visibility flag per face
+ * @param cullStats Receives the culling counters
+ */
+static void classifyFaces(CubeFrame* frame, CubeCullStats* cullStats)
+{
+    cullStats->facesTested = CUBE_FACE_COUNT;
+    cullStats->facesCulled = 0;
+    cullStats->samplesCulled = 0L;
+
+    for (int face = 0; face < CUBE_FACE_COUNT; face++) {
+        frame->visible[face] = !frame->cube->backFaceCulling || isFaceVisible(frame, &cubeFaces[face]);
+        if (!frame->visible[face]) {
+            cullStats->facesCulled++;
+        }
+    }
+
+    if (frame->cube->renderMode == CUBE_RENDER_SAMPLED) {
+        cullStats->samplesCulled = (long)cullStats->facesCulled * frame->edgeSamples * frame->edgeSamples;
+    }
+}
+
+void initializeCubeObject(CubeObject* cube)
+{
+    if (cube == NULL) {
+        return;
+    }
+
+    cube->width = DEFAULT_CUBE_WIDTH;
+    cube->incrementStep = CUBE_INCREMENT_STEP;
+    cube->renderMode = CUBE_RENDER_RASTERIZED;
+    cube->backFaceCulling = 1;
+    cube->traversalMode = CUBE_TRAVERSAL_INCREMENTAL;
+    cube->reanchorInterval = CUBE_REANCHOR_INTERVAL;
+    cube->parallelMode = CUBE_PARALLEL_TILED;
+    cube->rotation = (Rotation3D){0.0f, 0.0f, 0.0f};
+    cube->cullStats = (CubeCullStats){0, 0, 0L};
+}
+
+void drawCube(RenderContext* context, Rotation3D rotation)
+{
+    if (context == NULL) {
+        return;
+    }
+    CubeObject* cube = &context->cube;
+
+    /* Validate cube parameters */
+    if (cube->width <= 0.0f) {
+        return; /* Invalid cube dimensions */
+    }
+
+    if (cube->renderMode == CUBE_RENDER_SAMPLED && cube->incrementStep <= 0.0f) {
+        return; /* Invalid sampling resolution */
+    }
+
+    /* Per-frame work happens once here; tiles only read the result */
+    CubeFrame frame;
+    frame.context = context;
+    frame.cube = cube;
+    frame.transform = buildRotationTransform(rotation);
+    frame.projection = getRendererProjection(context);
+    frame.edgeSamples = cube->renderMode == CUBE_RENDER_SAMPLED ? countEdgeSamples(cube) : 0L;
+
+    /* Skip faces pointing away from the viewer before any per-point work */
+    classifyFaces(&frame, &cube->cullStats);
+    projectCubeFaces(&frame);
+
+    /* Fall back to tiles if the per-thread buffers cannot be allocated */
+    if (cube->parallelMode == CUBE_PARALLEL_WORK_STEALING) {
+        planCubeItems(&frame);
+        if (renderWorkStealing(context, frame.firstItem[CUBE_FACE_COUNT], drawCubeItem, &frame) == ALLOCATION_SUCCESS) {
+            resolveFrameBuffer(context);
+            return;
+        }
+    }
+
+    renderTiled(context, drawCubeRegion, &frame);
+    resolveFrameBuffer(context);
+}
+
+int createCubeMesh(Mesh* mesh, const CubeObject* cube)
+{
+    if (cube == NULL || !(cube->width > 0.0f) ||
+        initializeMesh(mesh, CUBE_FACE_COUNT * 4, CUBE_FACE_COUNT * 2, 1) != ALLOCATION_SUCCESS) {
+        return ALLOCATION_FAILURE;
+    }
+
+    /* Corners in (u, v) order around the face, counter-clockwise about uAxis x vAxis */
+    static const float corners[4][2] = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
+
+    for (int face = 0; face < CUBE_FACE_COUNT; face++) {
+        const CubeFace* cubeFace = &cubeFaces[face];
+        for (int corner = 0; corner < 4; corner++) {
+            const float u = corners[corner][0], v = corners[corner][1];
+            const int vertex = face * 4 + corner;
+            mesh->x[vertex] = cube->width * (cubeFace->normal.x + u * cubeFace->uAxis.x + v * cubeFace->vAxis.x);
+            mesh->y[vertex] = cube->width * (cubeFace->normal.y + u * cubeFace->uAxis.y + v * cubeFace->vAxis.y);
+            mesh->z[vertex] = cube->width * (cubeFace->normal.z + u * cubeFace->uAxis.z + v * cubeFace->vAxis.z);
+        }
+
+        /* Wind both triangles counter-clockwise as seen from outside the cube */
+        const Point3D* uAxis = &cubeFace->uAxis;
+        const Point3D* vAxis = &cubeFace->vAxis;
+        const Point3D* normal = &cubeFace->normal;
+        const float outward = (uAxis->y * vAxis->z - uAxis->z * vAxis->y) * normal->x +
+                              (uAxis->z * vAxis->x - uAxis->x * vAxis->z) * normal->y +
+                              (uAxis->x * vAxis->y - uAxis->y * vAxis->x) * normal->z;
+        static const int forward[6] = {0, 1, 2, 0, 2, 3};
+        static const int reverse[6] = {0, 2, 1, 0, 3, 2};
+        const int* order = outward > 0.0f ? forward : reverse;
+        for (int i = 0; i < 6; i++) {
+            mesh->indices[face * 6 + i] = face * 4 + order[i];
+        }
+        mesh->glyphs[face * 2] = (char)cubeFace->glyph;
+        mesh->glyphs[face * 2 + 1] = (char)cubeFace->glyph;
+    }
+
+    mesh->backFaceCulling = cube->backFaceCulling;
+    updateMeshNormals(mesh);
+    return ALLOCATION_SUCCESS;
+}
+
+CubeCullStats getCubeCullStats(const RenderContext* context)
+{
+    return context->cube.cullStats;
+}
+
+void incrementRotationAngles(RenderContext* context)
+{
+    context->cube.rotation.x += ROTATION_INCREMENT;
+    context->cube.rotation.y += ROTATION_INCREMENT;
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+/**
+ * @file eventloop.c
+ * @author D. Heger
+ * @brief Event loop implementation
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include "eventloop.h"
+
+static int epollFd = -1;
+static int signalFd = -1;
+static int timerFd = -1;
+static int watchingInput = 0;
+static int signalsBlocked = 0;
+static sigset_t savedSignalMask;
+
+int initializeEventLoop(long framePeriodMicroseconds)
+{
+    cleanupEventLoop();
+
+    if (framePeriodMicroseconds < 0) {
+        return ALLOCATION_FAILURE;
+    }
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGWINCH);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    if (pthread_sigmask(SIG_BLOCK, &signals, &savedSignalMask) != 0) {
+        return ALLOCATION_FAILURE;
+    }
+    signalsBlocked = 1;
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epollFd < 0 || signalFd < 0 || timerFd < 0) {
+        cleanupEventLoop();
+        return ALLOCATION_FAILURE;
+    }
+
+    /* Without a period the timer stays disarmed until scheduleFrameTick() */
+    struct itimerspec period;
+    period.it_interval.tv_sec = framePeriodMicroseconds / 1000000L;
+    period.it_interval.tv_nsec = framePeriodMicroseconds % 1000000L * 1000L;
+    period.it_value = period.it_interval;
+    if (framePeriodMicroseconds > 0 && timerfd_settime(timerFd, 0, &period, NULL) != 0) {
+        cleanupEventLoop();
+        return ALLOCATION_FAILURE;
+    }
+
+    struct epoll_event event = {0};
+    event.events = EPOLLIN;
+    event.data.fd = signalFd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, signalFd, &event) != 0) {
+        cleanupEventLoop();
+        return ALLOCATION_FAILURE;
+    }
+    event.data.fd = timerFd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &event) != 0) {
+        cleanupEventLoop();
+        return ALLOCATION_FAILURE;
+    }
+
+    /* Regular files (e.g. </dev/null) cannot be polled and never carry keys */
+    event.data.fd = STDIN_FILENO;
+    watchingInput = epoll_ctl(epollFd, EPOLL_CTL_ADD, STDIN_FILENO, &event) == 0;
+
+    return ALLOCATION_SUCCESS;
+}
+
+int scheduleFrameTick(const struct timespec* deadline)
+{
+    if (timerFd < 0 || deadline == NULL) {
+        return ALLOCATION_FAILURE;
+    }
+
+    struct itimerspec tick = {{0, 0}, *deadline};
+    if (tick.it_value.tv_sec == 0 && tick.it_value.tv_nsec == 0) {
+        tick.it_value.tv_nsec = 1; /* An all-zero value would disarm the timer */
+    }
+    return timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &tick, NULL) == 0 ? ALLOCATION_SUCCESS : ALLOCATION_FAILURE;
+}
+
+int waitForEvents(void)
+{
+    if (epollFd < 0) {
+        return ALLOCATION_FAILURE;
+    }
+
+    struct epoll_event ready[3];
+    int count;
+    do {
+        count = epoll_wait(epollFd, ready, 3, -1);
+    } while (count < 0 && errno == EINTR);
+    if (count < 0) {
+        return ALLOCATION_FAILURE;
+    }
+
+    int events = 0;
+    for (int i = 0; i < count; i++) {
+        const int fd = ready[i].data.fd;
+
+        if (fd == timerFd) {
+            uint64_t expirations;
+            if (read(timerFd, &expirations, sizeof(expirations)) == (ssize_t)sizeof(expirations)) {
+                events |= LOOP_EVENT_FRAME;
+            }
+        } else if (fd == signalFd) {
+            struct signalfd_siginfo info;
+            while (read(signalFd, &info, sizeof(info)) == (ssize_t)sizeof(info)) {
+                events |= info.ssi_signo == SIGWINCH ? LOOP_EVENT_RESIZE : LOOP_EVENT_QUIT;
+            }
+        } else if (ready[i].events & EPOLLIN) {
+            events |= LOOP_EVENT_INPUT;
+        } else if (watchingInput) {
+            /* Hang-up without data: no more keys will ever arrive */
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+            watchingInput = 0;
+        }
+    }
+
+    return events;
+}
+
+void cleanupEventLoop(void)
+{
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+    if (signalFd >= 0) {
+        close(signalFd);
+    }
+    if (timerFd >= 0) {
+        close(timerFd);
+    }
+    epollFd = signalFd = timerFd = -1;
+    watchingInput = 0;
+
+    if (signalsBlocked) {
+        pthread_sigmask(SIG_SETMASK, &savedSignalMask, NULL);
+        signalsBlocked = 0;
+    }
+}
@@ -8,29 +8,46 @@
 
 #include <termios.h>
 #include <unistd.h>
-#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
 #include <stdio.h>
 #include "input.h"
 
+/* Terminal state saved by setNonBlockingMode() and restored on exit */
+static struct termios originalTermios;
+static int terminalConfigured = 0;
+
 void setNonBlockingMode(void)
 {
-    struct termios ttystate;
+    if (terminalConfigured) {
+        return; /* Already in raw mode */
+    }
 
     /* Attempt to get current terminal state */
-    if (tcgetattr(STDIN_FILENO, &ttystate) != 0) {
+    if (tcgetattr(STDIN_FILENO, &originalTermios) != 0) {
         return; /* Failed to get terminal attributes */
     }
 
-    /* Configure non-canonical mode */
+    /* Configure non-canonical mode; reads return immediately */
+    struct termios ttystate = originalTermios;
     ttystate.c_lflag &= ~(ICANON | ECHO);
-    ttystate.c_cc[VMIN] = 1;
+    ttystate.c_cc[VMIN] = 0;
+    ttystate.c_cc[VTIME] = 0;
 
-    /* Apply new terminal settings */
-    tcsetattr(STDIN_FILENO, TCSANOW, &ttystate);
+    /* Apply new terminal settings once for the whole session */
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &ttystate) == 0) {
+        terminalConfigured = 1;
+    }
 }
 
 void resetTerminalMode(void)
 {
+    if (terminalConfigured) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &originalTermios);
+        terminalConfigured = 0;
+        return;
+    }
+
     struct termios ttystate;
     
     /* Attempt to get current terminal state */
@@ -45,51 +62,32 @@ void resetTerminalMode(void)
 
 int isKeyPressed(void)
 {
-    struct termios oldt, newt;
-    int ch;
-    int oldf;
+    struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+    char ch;
 
-    /* Save current terminal settings */
-    if (tcgetattr(STDIN_FILENO, &oldt) != 0) {
-        return 0; /* Failed to get terminal attributes */
-    }
-    newt = oldt;
-
-    /* Configure non-blocking mode */
-    newt.c_lflag &= ~(ICANON | ECHO);
-    if (tcsetattr(STDIN_FILENO, TCSANOW, &newt) != 0) {
-        return 0; /* Failed to set terminal attributes */
-    }
-    
-    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    if (oldf == -1) {
-        tcsetattr(STDIN_FILENO, TCSANOW, &oldt); /* Restore on error */
-        return 0;
-    }
-
-    /* Enable non-blocking read */
-    if (fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK) == -1) {
-        tcsetattr(STDIN_FILENO, TCSANOW, &oldt); /* Restore on error */
-        return 0;
-    }
-
-    ch = getchar();
-
-    /* Always restore original settings */
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
-
-    if (ch == EXIT_KEY_CODE) {
-        ungetc(ch, stdin); /* Put character back for potential reuse */
-        return 1;
+    /* Drain everything typed since the last frame, looking for the exit key */
+    while (poll(&input, 1, 0) > 0 && (input.revents & POLLIN)) {
+        if (read(STDIN_FILENO, &ch, 1) != 1) {
+            return 0; /* End of input or read error */
+        }
+        if (ch == EXIT_KEY_CODE) {
+            return 1;
+        }
     }
 
     return 0;
 }
 
-void wait(int sleep_microseconds)
+int getTerminalSize(int* columns, int* rows)
 {
-    if (sleep_microseconds > 0) {
-        usleep((useconds_t)sleep_microseconds);
+    struct winsize size;
+
+    if (columns == NULL || rows == NULL ||
+        ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_col == 0 || size.ws_row == 0) {
+        return ALLOCATION_FAILURE; /* Not a terminal or size unknown */
     }
-}
\ No newline at end of file
+
+    *columns = size.ws_col;
+    *rows = size.ws_row;
+    return ALLOCATION_SUCCESS;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file libcube.c
+ * @author D. Heger
+ * @brief Public library API over a private render context
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#include <stdlib.h>
+#include "libcube.h"
+#include "context.h"
+
+/* The public limits restate the internal ones so libcube.h stays self-contained */
+_Static_assert(CUBE_MIN_WIDTH == MIN_WINDOW_WIDTH && CUBE_MAX_WIDTH == MAX_WINDOW_WIDTH,
+               "libcube.h width limits out of sync with constants.h");
+_Static_assert(CUBE_MIN_HEIGHT == MIN_WINDOW_HEIGHT && CUBE_MAX_HEIGHT == MAX_WINDOW_HEIGHT,
+               "libcube.h height limits out of sync with constants.h");
+
+struct CubeRenderer
+{
+    RenderContext context;
+};
+
+CubeRenderer* createCubeRenderer(int width, int height)
+{
+    CubeRenderer* renderer = malloc(sizeof(*renderer));
+    if (renderer == NULL) {
+        return NULL;
+    }
+
+    initializeRenderContext(&renderer->context);
+    if (initializeRenderer(&renderer->context, width, height) != ALLOCATION_SUCCESS) {
+        free(renderer);
+        return NULL;
+    }
+
+    return renderer;
+}
+
+int resizeCubeRenderer(CubeRenderer* renderer, int width, int height)
+{
+    if (renderer == NULL) {
+        return CUBE_FAILURE;
+    }
+
+    /* The caller's buffer may be too small for the new size; fall back to the
+     * arena so the next renderCubeFrame() clears whatever buffer it gets */
+    if (bindRendererFrameBuffer(&renderer->context, NULL) != ALLOCATION_SUCCESS ||
+        resizeRenderer(&renderer->context, width, height) != ALLOCATION_SUCCESS) {
+        return CUBE_FAILURE;
+    }
+
+    return CUBE_SUCCESS;
+}
+
+int renderCubeFrame(CubeRenderer* renderer, float angleX, float angleY, float angleZ,
+                    char* frame, size_t frameSize)
+{
+    if (renderer == NULL || frame == NULL) {
+        return CUBE_FAILURE;
+    }
+
+    RenderContext* context = &renderer->context;
+    if (frameSize < (size_t)context->bufferSize) {
+        return CUBE_FAILURE;
+    }
+
+    /* Rasterize straight into the caller's cells; only a buffer switch clears in full */
+    if (bindRendererFrameBuffer(context, frame) != ALLOCATION_SUCCESS ||
+        initializeFrameBuffer(context) != ALLOCATION_SUCCESS ||
+        initializeDepthBuffer(context) != ALLOCATION_SUCCESS) {
+        return CUBE_FAILURE;
+    }
+
+    drawCube(context, (Rotation3D){angleX, angleY, angleZ});
+    return CUBE_SUCCESS;
+}
+
+void destroyCubeRenderer(CubeRenderer* renderer)
+{
+    if (renderer == NULL) {
+        return;
+    }
+
+    cleanupRenderer(&renderer->context);
+    free(renderer);
+}
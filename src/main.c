@@ -7,70 +7,243 @@
  * The architecture separates concerns across specialized modules:
  * - math3d: 3D transformation mathematics
  * - renderer: Display buffer management and projection
- * - input: Terminal interaction and timing
+ * - input: Terminal interaction
  * - cube: Geometry generation and animation
+ * - threadpool: Persistent workers for tiled rendering
+ * - config: Environment-driven runtime settings
+ * - worksteal: Work-stealing frame scheduling
+ * - present: Frame encoding and terminal output
+ * - eventloop: Input, signal and frame timer multiplexing
+ * - pacing: Deadline-based frame scheduling
+ * - context: Per-instance renderer and cube state
+ * - mesh: Indexed triangle meshes and OBJ/PLY loading
+ * - scene: Instanced meshes with grid-accelerated frustum culling
  *
  * @version 1.1.0
  * @date 2025-08-05
  */
 
 #include <stdio.h>
+#include <unistd.h>
 #include "constants.h"
 #include "math3d.h"
 #include "renderer.h"
+#include "context.h"
 #include "input.h"
 #include "cube.h"
+#include "mesh.h"
+#include "scene.h"
+#include "threadpool.h"
+#include "config.h"
+#include "present.h"
+#include "eventloop.h"
+#include "pacing.h"
 
-/* External buffer size reference */
-extern int bufferSize;
-extern char* frameBuffer;
+/**
+ * @brief Render the current rotation and hand the frame to the terminal
+ *
+ * @param context The context holding the cube and its buffers
+ * @param outputMode Presentation path started for this session
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
+ */
+static int renderFrame(RenderContext* context, PresentOutputMode outputMode)
+{
+    /* Clear buffers for new frame */
+    if (initializeFrameBuffer(context) != ALLOCATION_SUCCESS ||
+        initializeDepthBuffer(context) != ALLOCATION_SUCCESS) {
+        fprintf(stderr, "Error: Buffer initialization failed\n");
+        return ALLOCATION_FAILURE;
+    }
+
+    /* Generate and render cube geometry, or the configured mesh or scene */
+    if (context->scene != NULL) {
+        drawScene(context, context->scene, context->cube.rotation);
+    } else if (context->mesh != NULL) {
+        drawMesh(context, context->mesh, context->cube.rotation);
+    } else {
+        drawCube(context, context->cube.rotation);
+    }
+
+    /* Hand the frame to the terminal as selected by CUBE_OUTPUT; only the
+     * drawn rectangles of this and the last shown frame can have changed */
+    int presented;
+    switch (outputMode) {
+    case PRESENT_OUTPUT_THREADED:
+        presented = submitFrame(context);
+        break;
+    case PRESENT_OUTPUT_NONBLOCKING:
+        presented = presentFrameNonBlocking(context);
+        break;
+    default:
+        presented = presentFrame(STDOUT_FILENO, context);
+        break;
+    }
+    if (presented != ALLOCATION_SUCCESS) {
+        fprintf(stderr, "Error: Failed to write frame\n");
+    }
+    return presented;
+}
+
+/**
+ * @brief Size the render buffers to the terminal attached to stdout
+ *
+ * The first cell of each row carries the newline and the frame starts one
+ * line below the cursor-home position, so a terminal of C columns and R rows
+ * fits C x (R - 1) cells. Sizes are clamped to the supported range.
+ *
+ * @param width Receives the render width (unchanged if stdout is not a terminal)
+ * @param height Receives the render height (unchanged if stdout is not a terminal)
+ */
+static void getTerminalRenderSize(int* width, int* height)
+{
+    int columns, rows;
+    if (getTerminalSize(&columns, &rows) != ALLOCATION_SUCCESS) {
+        return;
+    }
+
+    rows -= 1;
+    *width = columns < MIN_WINDOW_WIDTH ? MIN_WINDOW_WIDTH : columns > MAX_WINDOW_WIDTH ? MAX_WINDOW_WIDTH : columns;
+    *height = rows < MIN_WINDOW_HEIGHT ? MIN_WINDOW_HEIGHT : rows > MAX_WINDOW_HEIGHT ? MAX_WINDOW_HEIGHT : rows;
+}
 
 int main(void)
 {
-    /* Initialize rendering system with default dimensions */
-    if (initializeRenderer(DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT) != ALLOCATION_SUCCESS) {
+    const RuntimeConfig config = loadRuntimeConfig();
+
+    /* With CUBE_FPS, frames follow absolute deadlines instead of a fixed timer */
+    const int paced = config.targetFps > 0 && initializeFramePacer(config.targetFps) == ALLOCATION_SUCCESS;
+
+    /* Initialize rendering system to the terminal size, or the defaults */
+    int width = DEFAULT_WINDOW_WIDTH, height = DEFAULT_WINDOW_HEIGHT;
+    getTerminalRenderSize(&width, &height);
+    RenderContext context;
+    initializeRenderContext(&context);
+    context.hugePages = config.hugePages;
+    if (initializeRenderer(&context, width, height) != ALLOCATION_SUCCESS) {
         fprintf(stderr, "Error: Failed to initialize rendering system\n");
         return 1;
     }
 
+    /* With CUBE_MESH, a model (or the cube built as a mesh) replaces drawCube();
+     * with CUBE_INSTANCES, a grid of copies of it does */
+    Mesh mesh;
+    if (config.meshPath != NULL || config.instanceCount > 0) {
+        if (loadConfiguredMesh(&config, &context.cube, &mesh) != ALLOCATION_SUCCESS) {
+            fprintf(stderr, "Error: Failed to load mesh\n");
+            cleanupRenderer(&context);
+            return 1;
+        }
+        context.mesh = &mesh;
+    }
+    Scene scene;
+    if (config.instanceCount > 0) {
+        if (loadConfiguredScene(&config, &context.cube, &mesh, &scene) != ALLOCATION_SUCCESS) {
+            fprintf(stderr, "Error: Failed to build scene\n");
+            destroyMesh(context.mesh);
+            cleanupRenderer(&context);
+            return 1;
+        }
+        context.scene = &scene;
+    }
+
+    /* Block signals before any thread exists so only the signalfd sees them */
+    if (initializeEventLoop(paced ? 0 : FRAME_DELAY_MICROSEC) != ALLOCATION_SUCCESS) {
+        fprintf(stderr, "Error: Failed to initialize event loop\n");
+        destroyScene(context.scene);
+        destroyMesh(context.mesh);
+        cleanupRenderer(&context);
+        return 1;
+    }
+
+    /* Start the tile workers; a failure only costs parallelism */
+    if (initializeThreadPool(config.renderThreads) != ALLOCATION_SUCCESS) {
+        fprintf(stderr, "Warning: Failed to start render threads, rendering single-threaded\n");
+    }
+
     /* Initialize terminal display */
     printf(CLEAR_SCREEN_SEQ);
+    fflush(stdout); /* Frames bypass stdio */
     setNonBlockingMode();
 
-    /* Main animation loop */
-    while (1) {
-        /* Clear buffers for new frame */
-        if (initializeFrameBuffer() != ALLOCATION_SUCCESS ||
-            initializeDepthBuffer() != ALLOCATION_SUCCESS) {
-            fprintf(stderr, "Error: Buffer initialization failed\n");
-            break;
-        }
+    /* Overlap terminal output with rendering, or avoid blocking on it; fall
+     * back to plain blocking writes if the selected mode cannot start */
+    PresentOutputMode outputMode = config.outputMode;
+    if ((outputMode == PRESENT_OUTPUT_THREADED && startPresenter(STDOUT_FILENO) != ALLOCATION_SUCCESS) ||
+        (outputMode == PRESENT_OUTPUT_NONBLOCKING && startNonBlockingOutput(STDOUT_FILENO) != ALLOCATION_SUCCESS)) {
+        outputMode = PRESENT_OUTPUT_BLOCKING;
+    }
 
-        /* Generate and render cube geometry */
-        drawCube(rotationAngles);
+    /* Paced ticks are armed one deadline at a time */
+    struct timespec deadline = getFrameDeadline();
+    if (paced) {
+        scheduleFrameTick(&deadline);
+    }
 
-        /* Display frame buffer to terminal */
-        printf(HOME_CURSOR_SEQ);
-        
-        /* Bounds-safe buffer display */
-        if (frameBuffer != NULL && bufferSize > 0) {
-            for (int pixelIndex = 0; pixelIndex < bufferSize; pixelIndex++) {
-                putchar(pixelIndex % windowWidth ? frameBuffer[pixelIndex] : '\n');
-            }
+    /* Main animation loop: sleep until the frame tick, a key or a signal */
+    while (1) {
+        const int events = waitForEvents();
+        if (events == ALLOCATION_FAILURE) {
+            fprintf(stderr, "Error: Waiting for events failed\n");
+            break;
         }
 
         /* Check for exit condition */
-        if (isKeyPressed()) {
+        if ((events & LOOP_EVENT_QUIT) || ((events & LOOP_EVENT_INPUT) && isKeyPressed())) {
             break;
         }
 
-        /* Update animation state */
-        incrementRotationAngles();
-        wait(FRAME_DELAY_MICROSEC);
+        /* Follow the terminal size (the old size is kept if that fails);
+         * the next frame redraws the whole screen */
+        if (events & LOOP_EVENT_RESIZE) {
+            getTerminalRenderSize(&width, &height);
+            resizeRenderer(&context, width, height);
+            resetPresentation();
+        }
+
+        if (events & LOOP_EVENT_FRAME) {
+            if (paced) {
+                beginPacedFrame();
+            }
+
+            if (renderFrame(&context, outputMode) != ALLOCATION_SUCCESS) {
+                break;
+            }
+
+            /* Update animation state */
+            incrementRotationAngles(&context);
+
+            if (paced) {
+                deadline = getFrameDeadline();
+                if (scheduleFrameTick(&deadline) != ALLOCATION_SUCCESS) {
+                    fprintf(stderr, "Error: Failed to schedule the next frame\n");
+                    break;
+                }
+            }
+        }
     }
 
     /* Cleanup and exit */
+    stopPresenter();
+    stopNonBlockingOutput();
     resetTerminalMode();
-    cleanupRenderer();
+
+    if (outputMode == PRESENT_OUTPUT_NONBLOCKING) {
+        const PresentStats presentStats = getPresentStats();
+        fprintf(stderr, "Output: %ld frames skipped, %ld partially sent\n",
+                presentStats.framesSkipped, presentStats.framesPartial);
+    }
+    if (paced) {
+        const FramePacingStats pacing = getFramePacingStats();
+        fprintf(stderr, "Pacing: %ld frames at %d FPS, %ld deadlines missed, %ld periods skipped\n",
+                pacing.frames, config.targetFps, pacing.missedDeadlines, pacing.periodsSkipped);
+        fprintf(stderr, "Lateness: mean %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+                pacing.meanLatenessMs, pacing.p50LatenessMs, pacing.p95LatenessMs,
+                pacing.p99LatenessMs, pacing.maxLatenessMs);
+    }
+    cleanupThreadPool();
+    cleanupEventLoop();
+    destroyScene(context.scene);
+    destroyMesh(context.mesh);
+    cleanupRenderer(&context);
     return 0;
 }
\ No newline at end of file
@@ -7,8 +7,15 @@
  */
 
 #include <math.h>
+#include <limits.h>
+#include <stddef.h>
 #include "math3d.h"
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define MATH3D_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
 /**
  * @brief Calculates the X coordinate of a point in 3D space based on the rotation of the coordinate system.
  *
@@ -62,4 +69,449 @@ float calculateZ(Point3D point, Rotation3D rotation)
     return point.z * cos(rotation.x) * cos(rotation.y) -
            point.y * sin(rotation.x) * cos(rotation.y) +
            point.x * sin(rotation.y);
-}
\ No newline at end of file
+}
+
+Transform3D buildRotationTransform(Rotation3D rotation)
+{
+    const double sinX = sin(rotation.x), cosX = cos(rotation.x);
+    const double sinY = sin(rotation.y), cosY = cos(rotation.y);
+    const double sinZ = sin(rotation.z), cosZ = cos(rotation.z);
+    Transform3D transform;
+
+    /* Row 0: coefficients of calculateX() */
+    transform.m[0][0] = (float)(cosY * cosZ);
+    transform.m[0][1] = (float)(sinX * sinY * cosZ + cosX * sinZ);
+    transform.m[0][2] = (float)(sinX * sinZ - cosX * sinY * cosZ);
+
+    /* Row 1: coefficients of calculateY() */
+    transform.m[1][0] = (float)(-cosY * sinZ);
+    transform.m[1][1] = (float)(cosX * cosZ - sinX * sinY * sinZ);
+    transform.m[1][2] = (float)(sinX * cosZ + cosX * sinY * sinZ);
+
+    /* Row 2: coefficients of calculateZ() */
+    transform.m[2][0] = (float)sinY;
+    transform.m[2][1] = (float)(-sinX * cosY);
+    transform.m[2][2] = (float)(cosX * cosY);
+
+    return transform;
+}
+
+Point3D transformPoint(const Transform3D* transform, Point3D point)
+{
+    Point3D result;
+    result.x = transform->m[0][0] * point.x + transform->m[0][1] * point.y + transform->m[0][2] * point.z;
+    result.y = transform->m[1][0] * point.x + transform->m[1][1] * point.y + transform->m[1][2] * point.z;
+    result.z = transform->m[2][0] * point.x + transform->m[2][1] * point.y + transform->m[2][2] * point.z;
+    return result;
+}
+
+/**
+ * @brief Truncate a float to int with the semantics of CVTTPS2DQ
+ *
+ * Out-of-range and NaN inputs yield INT_MIN, which keeps the scalar kernel
+ * bit-identical to the SIMD variants.
+ */
+static inline int truncateToInt(float value)
+{
+    if (value > -2147483648.0f && value < 2147483648.0f) {
+        return (int)value;
+    }
+    return INT_MIN;
+}
+
+/**
+ * @brief Project one rotated point (depth already includes the viewer offset)
+ */
+static inline void projectScalarPoint(const Projection3D* projection, float rotatedX, float rotatedY,
+                                      float depth, int* screenX, int* screenY, float* inverseDepth)
+{
+    /* Negated comparison also rejects NaN, matching the SIMD masks */
+    if (!(depth > 0.0f)) {
+        *screenX = -1;
+        *screenY = -1;
+        *inverseDepth = 0.0f;
+        return;
+    }
+
+    const float invDepth = 1.0f / depth;
+    *screenX = truncateToInt(projection->centerX + projection->scaleX * invDepth * rotatedX);
+    *screenY = truncateToInt(projection->centerY + projection->scaleY * invDepth * rotatedY);
+    *inverseDepth = invDepth;
+}
+
+static void transformProjectScalar(const Transform3D* transform, const Projection3D* projection,
+                                   const float* x, const float* y, const float* z, int count,
+                                   int* screenX, int* screenY, float* inverseDepth)
+{
+    const float m00 = transform->m[0][0], m01 = transform->m[0][1], m02 = transform->m[0][2];
+    const float m10 = transform->m[1][0], m11 = transform->m[1][1], m12 = transform->m[1][2];
+    const float m20 = transform->m[2][0], m21 = transform->m[2][1], m22 = transform->m[2][2];
+    const float distance = projection->viewerDistance;
+
+    for (int i = 0; i < count; i++) {
+        const float rotatedX = m00 * x[i] + m01 * y[i] + m02 * z[i];
+        const float rotatedY = m10 * x[i] + m11 * y[i] + m12 * z[i];
+        const float depth = m20 * x[i] + m21 * y[i] + m22 * z[i] + distance;
+        projectScalarPoint(projection, rotatedX, rotatedY, depth, &screenX[i], &screenY[i], &inverseDepth[i]);
+    }
+}
+
+static void projectScalar(const Projection3D* projection,
+                          const float* x, const float* y, const float* z, int count,
+                          int* screenX, int* screenY, float* inverseDepth)
+{
+    const float distance = projection->viewerDistance;
+
+    for (int i = 0; i < count; i++) {
+        projectScalarPoint(projection, x[i], y[i], z[i] + distance, &screenX[i], &screenY[i], &inverseDepth[i]);
+    }
+}
+
+#ifdef MATH3D_X86_SIMD
+
+/* -------------------------------------------------------------------------- */
+/* SSE2 (4 lanes)                                                             */
+/* -------------------------------------------------------------------------- */
+
+typedef struct
+{
+    __m128 distance, scaleX, scaleY, centerX, centerY;
+} ProjectionSse2;
+
+__attribute__((target("sse2")))
+static inline ProjectionSse2 broadcastProjectionSse2(const Projection3D* projection)
+{
+    ProjectionSse2 broadcast;
+    broadcast.distance = _mm_set1_ps(projection->viewerDistance);
+    broadcast.scaleX = _mm_set1_ps(projection->scaleX);
+    broadcast.scaleY = _mm_set1_ps(projection->scaleY);
+    broadcast.centerX = _mm_set1_ps(projection->centerX);
+    broadcast.centerY = _mm_set1_ps(projection->centerY);
+    return broadcast;
+}
+
+__attribute__((target("sse2")))
+static inline void projectLanesSse2(const ProjectionSse2* projection, __m128 rotatedX, __m128 rotatedY,
+                                    __m128 depth, int* screenX, int* screenY, float* inverseDepth)
+{
+    const __m128 visible = _mm_cmpgt_ps(depth, _mm_setzero_ps());
+    const __m128 invDepth = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), depth), visible);
+    const __m128i columns = _mm_cvttps_epi32(_mm_add_ps(projection->centerX, _mm_mul_ps(_mm_mul_ps(projection->scaleX, invDepth), rotatedX)));
+    const __m128i rows = _mm_cvttps_epi32(_mm_add_ps(projection->centerY, _mm_mul_ps(_mm_mul_ps(projection->scaleY, invDepth), rotatedY)));
+    const __m128i visibleMask = _mm_castps_si128(visible);
+    const __m128i offscreen = _mm_set1_epi32(-1);
+
+    _mm_storeu_si128((__m128i*)screenX,
+                     _mm_or_si128(_mm_and_si128(visibleMask, columns), _mm_andnot_si128(visibleMask, offscreen)));
+    _mm_storeu_si128((__m128i*)screenY,
+                     _mm_or_si128(_mm_and_si128(visibleMask, rows), _mm_andnot_si128(visibleMask, offscreen)));
+    _mm_storeu_ps(inverseDepth, invDepth);
+}
+
+__attribute__((target("sse2")))
+static void transformProjectSse2(const Transform3D* transform, const Projection3D* projection,
+                                 const float* x, const float* y, const float* z, int count,
+                                 int* screenX, int* screenY, float* inverseDepth)
+{
+    const __m128 m00 = _mm_set1_ps(transform->m[0][0]), m01 = _mm_set1_ps(transform->m[0][1]), m02 = _mm_set1_ps(transform->m[0][2]);
+    const __m128 m10 = _mm_set1_ps(transform->m[1][0]), m11 = _mm_set1_ps(transform->m[1][1]), m12 = _mm_set1_ps(transform->m[1][2]);
+    const __m128 m20 = _mm_set1_ps(transform->m[2][0]), m21 = _mm_set1_ps(transform->m[2][1]), m22 = _mm_set1_ps(transform->m[2][2]);
+    const ProjectionSse2 lanes = broadcastProjectionSse2(projection);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i), pz = _mm_loadu_ps(z + i);
+        const __m128 rotatedX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, px), _mm_mul_ps(m01, py)), _mm_mul_ps(m02, pz));
+        const __m128 rotatedY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, px), _mm_mul_ps(m11, py)), _mm_mul_ps(m12, pz));
+        const __m128 depth = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, px), _mm_mul_ps(m21, py)), _mm_mul_ps(m22, pz)), lanes.distance);
+        projectLanesSse2(&lanes, rotatedX, rotatedY, depth, screenX + i, screenY + i, inverseDepth + i);
+    }
+
+    transformProjectScalar(transform, projection, x + i, y + i, z + i, count - i,
+                           screenX + i, screenY + i, inverseDepth + i);
+}
+
+__attribute__((target("sse2")))
+static void projectSse2(const Projection3D* projection,
+                        const float* x, const float* y, const float* z, int count,
+                        int* screenX, int* screenY, float* inverseDepth)
+{
+    const ProjectionSse2 lanes = broadcastProjectionSse2(projection);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 depth = _mm_add_ps(_mm_loadu_ps(z + i), lanes.distance);
+        projectLanesSse2(&lanes, _mm_loadu_ps(x + i), _mm_loadu_ps(y + i), depth,
+                         screenX + i, screenY + i, inverseDepth + i);
+    }
+
+    projectScalar(projection, x + i, y + i, z + i, count - i, screenX + i, screenY + i, inverseDepth + i);
+}
+
+/* -------------------------------------------------------------------------- */
+/* AVX2 (8 lanes)                                                             */
+/* -------------------------------------------------------------------------- */
+
+typedef struct
+{
+    __m256 distance, scaleX, scaleY, centerX, centerY;
+} ProjectionAvx2;
+
+__attribute__((target("avx2")))
+static inline ProjectionAvx2 broadcastProjectionAvx2(const Projection3D* projection)
+{
+    ProjectionAvx2 broadcast;
+    broadcast.distance = _mm256_set1_ps(projection->viewerDistance);
+    broadcast.scaleX = _mm256_set1_ps(projection->scaleX);
+    broadcast.scaleY = _mm256_set1_ps(projection->scaleY);
+    broadcast.centerX = _mm256_set1_ps(projection->centerX);
+    broadcast.centerY = _mm256_set1_ps(projection->centerY);
+    return broadcast;
+}
+
+__attribute__((target("avx2")))
+static inline void projectLanesAvx2(const ProjectionAvx2* projection, __m256 rotatedX, __m256 rotatedY,
+                                    __m256 depth, int* screenX, int* screenY, float* inverseDepth)
+{
+    const __m256 visible = _mm256_cmp_ps(depth, _mm256_setzero_ps(), _CMP_GT_OQ);
+    const __m256 invDepth = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), depth), visible);
+    const __m256i columns = _mm256_cvttps_epi32(_mm256_add_ps(projection->centerX, _mm256_mul_ps(_mm256_mul_ps(projection->scaleX, invDepth), rotatedX)));
+    const __m256i rows = _mm256_cvttps_epi32(_mm256_add_ps(projection->centerY, _mm256_mul_ps(_mm256_mul_ps(projection->scaleY, invDepth), rotatedY)));
+    const __m256 offscreen = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+    _mm256_storeu_ps((float*)screenX, _mm256_blendv_ps(offscreen, _mm256_castsi256_ps(columns), visible));
+    _mm256_storeu_ps((float*)screenY, _mm256_blendv_ps(offscreen, _mm256_castsi256_ps(rows), visible));
+    _mm256_storeu_ps(inverseDepth, invDepth);
+}
+
+__attribute__((target("avx2")))
+static void transformProjectAvx2(const Transform3D* transform, const Projection3D* projection,
+                                 const float* x, const float* y, const float* z, int count,
+                                 int* screenX, int* screenY, float* inverseDepth)
+{
+    const __m256 m00 = _mm256_set1_ps(transform->m[0][0]), m01 = _mm256_set1_ps(transform->m[0][1]), m02 = _mm256_set1_ps(transform->m[0][2]);
+    const __m256 m10 = _mm256_set1_ps(transform->m[1][0]), m11 = _mm256_set1_ps(transform->m[1][1]), m12 = _mm256_set1_ps(transform->m[1][2]);
+    const __m256 m20 = _mm256_set1_ps(transform->m[2][0]), m21 = _mm256_set1_ps(transform->m[2][1]), m22 = _mm256_set1_ps(transform->m[2][2]);
+    const ProjectionAvx2 lanes = broadcastProjectionAvx2(projection);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        const __m256 px = _mm256_loadu_ps(x + i), py = _mm256_loadu_ps(y + i), pz = _mm256_loadu_ps(z + i);
+        const __m256 rotatedX = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, px), _mm256_mul_ps(m01, py)), _mm256_mul_ps(m02, pz));
+        const __m256 rotatedY = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m10, px), _mm256_mul_ps(m11, py)), _mm256_mul_ps(m12, pz));
+        const __m256 depth = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m20, px), _mm256_mul_ps(m21, py)), _mm256_mul_ps(m22, pz)), lanes.distance);
+        projectLanesAvx2(&lanes, rotatedX, rotatedY, depth, screenX + i, screenY + i, inverseDepth + i);
+    }
+
+    transformProjectScalar(transform, projection, x + i, y + i, z + i, count - i,
+                           screenX + i, screenY + i, inverseDepth + i);
+}
+
+__attribute__((target("avx2")))
+static void projectAvx2(const Projection3D* projection,
+                        const float* x, const float* y, const float* z, int count,
+                        int* screenX, int* screenY, float* inverseDepth)
+{
+    const ProjectionAvx2 lanes = broadcastProjectionAvx2(projection);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        const __m256 depth = _mm256_add_ps(_mm256_loadu_ps(z + i), lanes.distance);
+        projectLanesAvx2(&lanes, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), depth,
+                         screenX + i, screenY + i, inverseDepth + i);
+    }
+
+    projectScalar(projection, x + i, y + i, z + i, count - i, screenX + i, screenY + i, inverseDepth + i);
+}
+
+/* -------------------------------------------------------------------------- */
+/* AVX-512F (16 lanes)                                                        */
+/* -------------------------------------------------------------------------- */
+
+typedef struct
+{
+    __m512 distance, scaleX, scaleY, centerX, centerY;
+} ProjectionAvx512;
+
+__attribute__((target("avx512f")))
+static inline ProjectionAvx512 broadcastProjectionAvx512(const Projection3D* projection)
+{
+    ProjectionAvx512 broadcast;
+    broadcast.distance = _mm512_set1_ps(projection->viewerDistance);
+    broadcast.scaleX = _mm512_set1_ps(projection->scaleX);
+    broadcast.scaleY = _mm512_set1_ps(projection->scaleY);
+    broadcast.centerX = _mm512_set1_ps(projection->centerX);
+    broadcast.centerY = _mm512_set1_ps(projection->centerY);
+    return broadcast;
+}
+
+__attribute__((target("avx512f")))
+static inline void projectLanesAvx512(const ProjectionAvx512* projection, __m512 rotatedX, __m512 rotatedY,
+                                      __m512 depth, int* screenX, int* screenY, float* inverseDepth)
+{
+    const __mmask16 visible = _mm512_cmp_ps_mask(depth, _mm512_setzero_ps(), _CMP_GT_OQ);
+    const __m512 invDepth = _mm512_maskz_div_ps(visible, _mm512_set1_ps(1.0f), depth);
+    const __m512 columns = _mm512_add_ps(projection->centerX, _mm512_mul_ps(_mm512_mul_ps(projection->scaleX, invDepth), rotatedX));
+    const __m512 rows = _mm512_add_ps(projection->centerY, _mm512_mul_ps(_mm512_mul_ps(projection->scaleY, invDepth), rotatedY));
+    const __m512i offscreen = _mm512_set1_epi32(-1);
+
+    _mm512_storeu_si512(screenX, _mm512_mask_cvttps_epi32(offscreen, visible, columns));
+    _mm512_storeu_si512(screenY, _mm512_mask_cvttps_epi32(offscreen, visible, rows));
+    _mm512_storeu_ps(inverseDepth, invDepth);
+}
+
+__attribute__((target("avx512f")))
+static void transformProjectAvx512(const Transform3D* transform, const Projection3D* projection,
+                                   const float* x, const float* y, const float* z, int count,
+                                   int* screenX, int* screenY, float* inverseDepth)
+{
+    const __m512 m00 = _mm512_set1_ps(transform->m[0][0]), m01 = _mm512_set1_ps(transform->m[0][1]), m02 = _mm512_set1_ps(transform->m[0][2]);
+    const __m512 m10 = _mm512_set1_ps(transform->m[1][0]), m11 = _mm512_set1_ps(transform->m[1][1]), m12 = _mm512_set1_ps(transform->m[1][2]);
+    const __m512 m20 = _mm512_set1_ps(transform->m[2][0]), m21 = _mm512_set1_ps(transform->m[2][1]), m22 = _mm512_set1_ps(transform->m[2][2]);
+    const ProjectionAvx512 lanes = broadcastProjectionAvx512(projection);
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        const __m512 px = _mm512_loadu_ps(x + i), py = _mm512_loadu_ps(y + i), pz = _mm512_loadu_ps(z + i);
+        const __m512 rotatedX = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(m00, px), _mm512_mul_ps(m01, py)), _mm512_mul_ps(m02, pz));
+        const __m512 rotatedY = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(m10, px), _mm512_mul_ps(m11, py)), _mm512_mul_ps(m12, pz));
+        const __m512 depth = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(m20, px), _mm512_mul_ps(m21, py)), _mm512_mul_ps(m22, pz)), lanes.distance);
+        projectLanesAvx512(&lanes, rotatedX, rotatedY, depth, screenX + i, screenY + i, inverseDepth + i);
+    }
+
+    transformProjectScalar(transform, projection, x + i, y + i, z + i, count - i,
+                           screenX + i, screenY + i, inverseDepth + i);
+}
+
+__attribute__((target("avx512f")))
+static void projectAvx512(const Projection3D* projection,
+                          const float* x, const float* y, const float* z, int count,
+                          int* screenX, int* screenY, float* inverseDepth)
+{
+    const ProjectionAvx512 lanes = broadcastProjectionAvx512(projection);
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        const __m512 depth = _mm512_add_ps(_mm512_loadu_ps(z + i), lanes.distance);
+        projectLanesAvx512(&lanes, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), depth,
+                           screenX + i, screenY + i, inverseDepth + i);
+    }
+
+    projectScalar(projection, x + i, y + i, z + i, count - i, screenX + i, screenY + i, inverseDepth + i);
+}
+
+#endif /* MATH3D_X86_SIMD */
+
+/* -------------------------------------------------------------------------- */
+/* Runtime dispatch                                                           */
+/* -------------------------------------------------------------------------- */
+
+typedef void (*TransformProjectFunction)(const Transform3D*, const Projection3D*,
+                                         const float*, const float*, const float*, int,
+                                         int*, int*, float*);
+
+typedef void (*ProjectFunction)(const Projection3D*,
+                                const float*, const float*, const float*, int,
+                                int*, int*, float*);
+
+/**
+ * @brief Entry points implemented by one kernel variant
+ */
+typedef struct
+{
+    const char* name;
+    TransformProjectFunction transformProject;
+    ProjectFunction project;
+} KernelFunctions;
+
+static const KernelFunctions kernelTable[TRANSFORM_KERNEL_COUNT] = {
+    {"scalar", transformProjectScalar, projectScalar},
+#ifdef MATH3D_X86_SIMD
+    {"sse2", transformProjectSse2, projectSse2},
+    {"avx2", transformProjectAvx2, projectAvx2},
+    {"avx512", transformProjectAvx512, projectAvx512},
+#else
+    {"sse2", NULL, NULL},
+    {"avx2", NULL, NULL},
+    {"avx512", NULL, NULL},
+#endif
+};
+
+static TransformKernel activeKernel = TRANSFORM_KERNEL_SCALAR;
+static const KernelFunctions* activeFunctions = &kernelTable[TRANSFORM_KERNEL_SCALAR];
+
+/**
+ * @brief Check whether the CPU can execute a kernel variant
+ */
+static int isKernelSupported(TransformKernel kernel)
+{
+    switch (kernel) {
+    case TRANSFORM_KERNEL_SCALAR:
+        return 1;
+#ifdef MATH3D_X86_SIMD
+    case TRANSFORM_KERNEL_SSE2:
+        return __builtin_cpu_supports("sse2");
+    case TRANSFORM_KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2");
+    case TRANSFORM_KERNEL_AVX512:
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Select the widest supported kernel before main() runs
+ */
+__attribute__((constructor))
+static void detectTransformKernel(void)
+{
+#ifdef MATH3D_X86_SIMD
+    __builtin_cpu_init();
+#endif
+    for (int kernel = TRANSFORM_KERNEL_COUNT - 1; kernel >= TRANSFORM_KERNEL_SCALAR; kernel--) {
+        if (setTransformKernel((TransformKernel)kernel)) {
+            return;
+        }
+    }
+}
+
+void transformProjectBatch(const Transform3D* transform, const Projection3D* projection,
+                           const float* x, const float* y, const float* z, int count,
+                           int* screenX, int* screenY, float* inverseDepth)
+{
+    activeFunctions->transformProject(transform, projection, x, y, z, count, screenX, screenY, inverseDepth);
+}
+
+void projectBatch(const Projection3D* projection,
+                  const float* x, const float* y, const float* z, int count,
+                  int* screenX, int* screenY, float* inverseDepth)
+{
+    activeFunctions->project(projection, x, y, z, count, screenX, screenY, inverseDepth);
+}
+
+TransformKernel getTransformKernel(void)
+{
+    return activeKernel;
+}
+
+int setTransformKernel(TransformKernel kernel)
+{
+    if (kernel < TRANSFORM_KERNEL_SCALAR || kernel >= TRANSFORM_KERNEL_COUNT ||
+        kernelTable[kernel].transformProject == NULL || !isKernelSupported(kernel)) {
+        return 0;
+    }
+
+    activeKernel = kernel;
+    activeFunctions = &kernelTable[kernel];
+    return 1;
+}
+
+const char* getTransformKernelName(TransformKernel kernel)
+{
+    if (kernel < TRANSFORM_KERNEL_SCALAR || kernel >= TRANSFORM_KERNEL_COUNT) {
+        return "unknown";
+    }
+    return kernelTable[kernel].name;
+}
@@ -0,0 +1,1108 @@
+/**
+ * @file mesh.c
+ * @author D. Heger
+ * @brief Mesh storage, OBJ/PLY loading and mesh rendering
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mesh.h"
+#include "context.h"
+#include "threadpool.h"
+
+/**
+ * @brief Parse pass over a mapped model file
+ *
+ * Called once without a mesh to count vertices and triangles, then again
+ * with the mesh allocated for those counts to fill it.
+ *
+ * @param mesh The mesh to fill, or NULL for the counting pass
+ * @param error Receives a static description of a failure
+ */
+typedef int (*MeshParser)(const char* data, size_t size, Mesh* mesh,
+                          int* vertexCount, int* triangleCount, const char** error);
+
+/**
+ * @brief Round size up to a multiple of alignment (a power of two)
+ */
+static size_t alignUp(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+int initializeMesh(Mesh* mesh, int vertexCount, int triangleCount, int withGlyphs)
+{
+    if (mesh == NULL || vertexCount < 1 || vertexCount > MESH_MAX_VERTICES ||
+        triangleCount < 1 || triangleCount > MESH_MAX_TRIANGLES) {
+        return ALLOCATION_FAILURE;
+    }
+    memset(mesh, 0, sizeof(*mesh));
+
+    /* Six float arrays per vertex (position and projection), five per
+     * triangle (indices count three, tile spans one) and two glyph arrays */
+    const size_t vertexBytes = alignUp((size_t)vertexCount * sizeof(float), RENDER_ARENA_ALIGNMENT);
+    const size_t indexBytes = alignUp((size_t)triangleCount * 3 * sizeof(int), RENDER_ARENA_ALIGNMENT);
+    const size_t normalBytes = alignUp((size_t)triangleCount * sizeof(float), RENDER_ARENA_ALIGNMENT);
+    const size_t glyphBytes = alignUp((size_t)triangleCount, RENDER_ARENA_ALIGNMENT);
+    const size_t bytes = 6 * vertexBytes + indexBytes + 4 * normalBytes + 2 * glyphBytes;
+
+    void* block = NULL;
+    if (posix_memalign(&block, RENDER_ARENA_ALIGNMENT, bytes) != 0) {
+        return ALLOCATION_FAILURE;
+    }
+
+    char* cursor = (char*)block;
+    mesh->x = (float*)cursor;               cursor += vertexBytes;
+    mesh->y = (float*)cursor;               cursor += vertexBytes;
+    mesh->z = (float*)cursor;               cursor += vertexBytes;
+    mesh->screenX = (float*)cursor;         cursor += vertexBytes;
+    mesh->screenY = (float*)cursor;         cursor += vertexBytes;
+    mesh->inverseDepth = (float*)cursor;    cursor += vertexBytes;
+    mesh->indices = (int*)cursor;           cursor += indexBytes;
+    mesh->normalX = (float*)cursor;         cursor += normalBytes;
+    mesh->normalY = (float*)cursor;         cursor += normalBytes;
+    mesh->normalZ = (float*)cursor;         cursor += normalBytes;
+    mesh->tileSpans = (uint32_t*)cursor;    cursor += normalBytes;
+    mesh->shading = cursor;                 cursor += glyphBytes;
+    mesh->glyphs = withGlyphs ? cursor : NULL;
+
+    mesh->vertexCount = vertexCount;
+    mesh->triangleCount = triangleCount;
+    mesh->backFaceCulling = 0;
+    mesh->block = block;
+    return ALLOCATION_SUCCESS;
+}
+
+void destroyMesh(Mesh* mesh)
+{
+    if (mesh == NULL) {
+        return;
+    }
+    free(mesh->block);
+    free(mesh->tileBins);
+    memset(mesh, 0, sizeof(*mesh));
+}
+
+/* -------------------------------------------------------------------------- */
+/* Text scanning                                                              */
+/* -------------------------------------------------------------------------- */
+
+static int isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static void skipBlanks(const char** cursor, const char* end)
+{
+    while (*cursor < end && isBlank(**cursor)) {
+        (*cursor)++;
+    }
+}
+
+static void skipWhitespace(const char** cursor, const char* end)
+{
+    while (*cursor < end && (isBlank(**cursor) || **cursor == '\n')) {
+        (*cursor)++;
+    }
+}
+
+static void skipToken(const char** cursor, const char* end)
+{
+    while (*cursor < end && !isBlank(**cursor) && **cursor != '\n') {
+        (*cursor)++;
+    }
+}
+
+static void skipLine(const char** cursor, const char* end)
+{
+    const char* newline = memchr(*cursor, '\n', (size_t)(end - *cursor));
+    *cursor = newline != NULL ? newline + 1 : end;
+}
+
+/**
+ * @brief Parse a decimal number bounded by end (the mapping has no terminator)
+ *
+ * Accepts [+-]digits[.digits][(e|E)[+-]digits] with at least one mantissa
+ * digit. Up to 19 significant digits are kept, which is beyond float precision.
+ *
+ * @return 1 and advances cursor on success, 0 if no number starts at cursor
+ */
+static int parseReal(const char** cursor, const char* end, double* value)
+{
+    static const double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* c = *cursor;
+    int negative = 0;
+    if (c < end && (*c == '+' || *c == '-')) {
+        negative = *c == '-';
+        c++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0, significant = 0, exponent = 0;
+    for (; c < end && *c >= '0' && *c <= '9'; c++, digits++) {
+        if (significant < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(*c - '0');
+            significant += mantissa != 0;
+        } else {
+            exponent++;
+        }
+    }
+    if (c < end && *c == '.') {
+        for (c++; c < end && *c >= '0' && *c <= '9'; c++, digits++) {
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*c - '0');
+                significant += mantissa != 0;
+                exponent--;
+            }
+        }
+    }
+    if (digits == 0) {
+        return 0;
+    }
+
+    if (c < end && (*c == 'e' || *c == 'E')) {
+        const char* e = c + 1;
+        int exponentNegative = 0;
+        if (e < end && (*e == '+' || *e == '-')) {
+            exponentNegative = *e == '-';
+            e++;
+        }
+        if (e < end && *e >= '0' && *e <= '9') {
+            int written = 0;
+            for (; e < end && *e >= '0' && *e <= '9'; e++) {
+                written = written < 10000 ? written * 10 + (*e - '0') : written;
+            }
+            exponent += exponentNegative ? -written : written;
+            c = e;
+        }
+    }
+
+    double result = (double)mantissa;
+    if (exponent >= -22 && exponent <= 22) {
+        result = exponent < 0 ? result / powersOfTen[-exponent] : result * powersOfTen[exponent];
+    } else {
+        result *= pow(10.0, (double)exponent);
+    }
+
+    *value = negative ? -result : result;
+    *cursor = c;
+    return 1;
+}
+
+/**
+ * @brief Parse a decimal integer bounded by end
+ *
+ * @return 1 and advances cursor on success, 0 if no integer starts at cursor
+ */
+static int parseInteger(const char** cursor, const char* end, long* value)
+{
+    const char* c = *cursor;
+    int negative = 0;
+    if (c < end && (*c == '+' || *c == '-')) {
+        negative = *c == '-';
+        c++;
+    }
+
+    long result = 0;
+    const char* digits = c;
+    for (; c < end && *c >= '0' && *c <= '9'; c++) {
+        result = result < 100000000000L ? result * 10 + (*c - '0') : result;
+    }
+    if (c == digits) {
+        return 0;
+    }
+
+    *value = negative ? -result : result;
+    *cursor = c;
+    return 1;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Wavefront OBJ                                                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Parse "v" and "f" records of an OBJ file
+ *
+ * Face corners may be written as v, v/vt, v//vn or v/vt/vn; only the
+ * position index is used. Indices refer to the vertices declared before the
+ * face; negative ones count back from the last of them.
+ */
+static int parseObj(const char* data, size_t size, Mesh* mesh,
+                    int* vertexCount, int* triangleCount, const char** error)
+{
+    const char* cursor = data;
+    const char* end = data + size;
+    int vertices = 0, triangles = 0;
+
+    while (cursor < end) {
+        skipBlanks(&cursor, end);
+        if (end - cursor < 2 || !isBlank(cursor[1])) {
+            skipLine(&cursor, end);
+            continue;
+        }
+
+        if (cursor[0] == 'v') {
+            cursor++;
+            if (vertices >= MESH_MAX_VERTICES) {
+                *error = "too many vertices";
+                return ALLOCATION_FAILURE;
+            }
+            if (mesh != NULL) {
+                float position[3];
+                for (int axis = 0; axis < 3; axis++) {
+                    double value;
+                    skipBlanks(&cursor, end);
+                    /* Out-of-range coordinates would turn every vertex to NaN in fitMesh() */
+                    if (!parseReal(&cursor, end, &value) || !isfinite((float)value)) {
+                        *error = "malformed vertex";
+                        return ALLOCATION_FAILURE;
+                    }
+                    position[axis] = (float)value;
+                }
+                mesh->x[vertices] = position[0];
+                mesh->y[vertices] = position[1];
+                mesh->z[vertices] = position[2];
+            }
+            vertices++;
+        } else if (cursor[0] == 'f') {
+            cursor++;
+            int corners = 0, first = 0, previous = 0;
+            for (;;) {
+                skipBlanks(&cursor, end);
+                long index;
+                if (!parseInteger(&cursor, end, &index)) {
+                    break;
+                }
+                skipToken(&cursor, end);
+
+                const long resolved = index > 0 ? index - 1 : vertices + index;
+                if (index == 0 || resolved < 0 || resolved >= vertices) {
+                    *error = "face references a missing vertex";
+                    return ALLOCATION_FAILURE;
+                }
+                const int vertex = (int)resolved;
+
+                /* Split polygons into a fan around the first corner */
+                if (corners >= 2) {
+                    if (triangles >= MESH_MAX_TRIANGLES) {
+                        *error = "too many triangles";
+                        return ALLOCATION_FAILURE;
+                    }
+                    if (mesh != NULL) {
+                        int* triangle = mesh->indices + 3 * (size_t)triangles;
+                        triangle[0] = first;
+                        triangle[1] = previous;
+                        triangle[2] = vertex;
+                    }
+                    triangles++;
+                }
+                first = corners == 0 ? vertex : first;
+                previous = vertex;
+                corners++;
+            }
+            if (cursor < end && *cursor != '\n' && *cursor != '#') {
+                *error = "malformed face";
+                return ALLOCATION_FAILURE;
+            }
+        }
+        skipLine(&cursor, end);
+    }
+
+    *vertexCount = vertices;
+    *triangleCount = triangles;
+    return ALLOCATION_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Stanford PLY                                                               */
+/* -------------------------------------------------------------------------- */
+
+typedef enum
+{
+    PLY_TYPE_NONE = 0,
+    PLY_TYPE_INT8,
+    PLY_TYPE_UINT8,
+    PLY_TYPE_INT16,
+    PLY_TYPE_UINT16,
+    PLY_TYPE_INT32,
+    PLY_TYPE_UINT32,
+    PLY_TYPE_FLOAT32,
+    PLY_TYPE_FLOAT64
+} PlyType;
+
+typedef enum
+{
+    PLY_FORMAT_ASCII = 0,
+    PLY_FORMAT_BINARY_LITTLE_ENDIAN,
+    PLY_FORMAT_BINARY_BIG_ENDIAN
+} PlyFormat;
+
+/**
+ * @brief What a property contributes to the mesh
+ */
+typedef enum
+{
+    PLY_ROLE_OTHER = 0,
+    PLY_ROLE_X,
+    PLY_ROLE_Y,
+    PLY_ROLE_Z,
+    PLY_ROLE_INDICES
+} PlyRole;
+
+typedef struct
+{
+    PlyType type;           /**< Scalar type, or item type of a list */
+    PlyType countType;      /**< Type of the list length, PLY_TYPE_NONE for scalars */
+    PlyRole role;
+} PlyProperty;
+
+typedef struct
+{
+    long count;
+    int isVertex;
+    int isFace;
+    int propertyCount;
+    PlyProperty properties[MESH_PLY_MAX_PROPERTIES];
+} PlyElement;
+
+typedef struct
+{
+    PlyFormat format;
+    int elementCount;
+    PlyElement elements[MESH_PLY_MAX_ELEMENTS];
+    const char* body;       /**< First byte after the end_header line */
+} PlyHeader;
+
+/**
+ * @brief Sequential reader over the body of a PLY file
+ */
+typedef struct
+{
+    const char* cursor;
+    const char* end;
+    PlyFormat format;
+} PlyReader;
+
+/**
+ * @brief Copy the next word of the current line into word
+ *
+ * @return Length of the word, 0 at the end of the line
+ */
+static size_t readWord(const char** cursor, const char* end, char word[MESH_PLY_MAX_WORD])
+{
+    skipBlanks(cursor, end);
+    const char* start = *cursor;
+    skipToken(cursor, end);
+    size_t length = (size_t)(*cursor - start);
+    length = length < MESH_PLY_MAX_WORD - 1 ? length : MESH_PLY_MAX_WORD - 1;
+    memcpy(word, start, length);
+    word[length] = '\0';
+    return length;
+}
+
+static PlyType parsePlyType(const char* name)
+{
+    static const struct
+    {
+        const char* name;
+        PlyType type;
+    } names[] = {
+        {"char", PLY_TYPE_INT8},     {"int8", PLY_TYPE_INT8},
+        {"uchar", PLY_TYPE_UINT8},   {"uint8", PLY_TYPE_UINT8},
+        {"short", PLY_TYPE_INT16},   {"int16", PLY_TYPE_INT16},
+        {"ushort", PLY_TYPE_UINT16}, {"uint16", PLY_TYPE_UINT16},
+        {"int", PLY_TYPE_INT32},     {"int32", PLY_TYPE_INT32},
+        {"uint", PLY_TYPE_UINT32},   {"uint32", PLY_TYPE_UINT32},
+        {"float", PLY_TYPE_FLOAT32}, {"float32", PLY_TYPE_FLOAT32},
+        {"double", PLY_TYPE_FLOAT64}, {"float64", PLY_TYPE_FLOAT64},
+    };
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i].name) == 0) {
+            return names[i].type;
+        }
+    }
+    return PLY_TYPE_NONE;
+}
+
+static size_t plyTypeSize(PlyType type)
+{
+    switch (type) {
+    case PLY_TYPE_INT8:
+    case PLY_TYPE_UINT8:
+        return 1;
+    case PLY_TYPE_INT16:
+    case PLY_TYPE_UINT16:
+        return 2;
+    case PLY_TYPE_FLOAT64:
+        return 8;
+    default:
+        return 4;
+    }
+}
+
+/**
+ * @brief Parse the header up to and including the end_header line
+ */
+static int parsePlyHeader(const char* data, size_t size, PlyHeader* header, const char** error)
+{
+    const char* cursor = data;
+    const char* end = data + size;
+    char word[MESH_PLY_MAX_WORD];
+    int formatSeen = 0;
+
+    memset(header, 0, sizeof(*header));
+    skipLine(&cursor, end); /* The "ply" magic line */
+
+    while (cursor < end) {
+        readWord(&cursor, end, word);
+
+        if (strcmp(word, "format") == 0) {
+            readWord(&cursor, end, word);
+            if (strcmp(word, "ascii") == 0) {
+                header->format = PLY_FORMAT_ASCII;
+            } else if (strcmp(word, "binary_little_endian") == 0) {
+                header->format = PLY_FORMAT_BINARY_LITTLE_ENDIAN;
+            } else if (strcmp(word, "binary_big_endian") == 0) {
+                header->format = PLY_FORMAT_BINARY_BIG_ENDIAN;
+            } else {
+                *error = "unsupported PLY format";
+                return ALLOCATION_FAILURE;
+            }
+            formatSeen = 1;
+        } else if (strcmp(word, "element") == 0) {
+            if (header->elementCount >= MESH_PLY_MAX_ELEMENTS) {
+                *error = "too many PLY elements";
+                return ALLOCATION_FAILURE;
+            }
+            PlyElement* element = &header->elements[header->elementCount++];
+            readWord(&cursor, end, word);
+            element->isVertex = strcmp(word, "vertex") == 0;
+            element->isFace = strcmp(word, "face") == 0;
+            skipBlanks(&cursor, end);
+            if (!parseInteger(&cursor, end, &element->count) || element->count < 0) {
+                *error = "malformed PLY element";
+                return ALLOCATION_FAILURE;
+            }
+        } else if (strcmp(word, "property") == 0) {
+            if (header->elementCount == 0 ||
+                header->elements[header->elementCount - 1].propertyCount >= MESH_PLY_MAX_PROPERTIES) {
+                *error = "unexpected PLY property";
+                return ALLOCATION_FAILURE;
+            }
+            PlyElement* element = &header->elements[header->elementCount - 1];
+            PlyProperty* property = &element->properties[element->propertyCount++];
+            readWord(&cursor, end, word);
+            if (strcmp(word, "list") == 0) {
+                readWord(&cursor, end, word);
+                property->countType = parsePlyType(word);
+                readWord(&cursor, end, word);
+                property->type = parsePlyType(word);
+                if (property->countType == PLY_TYPE_NONE) {
+                    *error = "unknown PLY property type";
+                    return ALLOCATION_FAILURE;
+                }
+            } else {
+                property->type = parsePlyType(word);
+            }
+            if (property->type == PLY_TYPE_NONE) {
+                *error = "unknown PLY property type";
+                return ALLOCATION_FAILURE;
+            }
+
+            readWord(&cursor, end, word);
+            if (element->isVertex && property->countType == PLY_TYPE_NONE) {
+                property->role = strcmp(word, "x") == 0 ? PLY_ROLE_X
+                               : strcmp(word, "y") == 0 ? PLY_ROLE_Y
+                               : strcmp(word, "z") == 0 ? PLY_ROLE_Z : PLY_ROLE_OTHER;
+            } else if (element->isFace && property->countType != PLY_TYPE_NONE &&
+                       (strcmp(word, "vertex_indices") == 0 || strcmp(word, "vertex_index") == 0)) {
+                property->role = PLY_ROLE_INDICES;
+            }
+        } else if (strcmp(word, "end_header") == 0) {
+            skipLine(&cursor, end);
+            header->body = cursor;
+            if (!formatSeen) {
+                *error = "PLY header without format";
+                return ALLOCATION_FAILURE;
+            }
+            return ALLOCATION_SUCCESS;
+        }
+        /* comment, obj_info and unknown keywords are ignored */
+        skipLine(&cursor, end);
+    }
+
+    *error = "PLY header without end_header";
+    return ALLOCATION_FAILURE;
+}
+
+/**
+ * @brief Read the next value of the given type from the body
+ *
+ * @return 1 on success, 0 if the data ends early or is not a number
+ */
+static int readPlyValue(PlyReader* reader, PlyType type, double* value)
+{
+    if (reader->format == PLY_FORMAT_ASCII) {
+        skipWhitespace(&reader->cursor, reader->end);
+        return parseReal(&reader->cursor, reader->end, value);
+    }
+
+    const size_t bytes = plyTypeSize(type);
+    if ((size_t)(reader->end - reader->cursor) < bytes) {
+        return 0;
+    }
+
+    unsigned char raw[8];
+    memcpy(raw, reader->cursor, bytes);
+    reader->cursor += bytes;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    const PlyFormat hostFormat = PLY_FORMAT_BINARY_BIG_ENDIAN;
+#else
+    const PlyFormat hostFormat = PLY_FORMAT_BINARY_LITTLE_ENDIAN;
+#endif
+    if (reader->format != hostFormat) {
+        for (size_t i = 0; i < bytes / 2; i++) {
+            const unsigned char swap = raw[i];
+            raw[i] = raw[bytes - 1 - i];
+            raw[bytes - 1 - i] = swap;
+        }
+    }
+
+    switch (type) {
+    case PLY_TYPE_INT8:    { int8_t v;   memcpy(&v, raw, sizeof(v)); *value = v; break; }
+    case PLY_TYPE_UINT8:   { uint8_t v;  memcpy(&v, raw, sizeof(v)); *value = v; break; }
+    case PLY_TYPE_INT16:   { int16_t v;  memcpy(&v, raw, sizeof(v)); *value = v; break; }
+    case PLY_TYPE_UINT16:  { uint16_t v; memcpy(&v, raw, sizeof(v)); *value = v; break; }
+    case PLY_TYPE_INT32:   { int32_t v;  memcpy(&v, raw, sizeof(v)); *value = v; break; }
+    case PLY_TYPE_UINT32:  { uint32_t v; memcpy(&v, raw, sizeof(v)); *value = v; break; }
+    case PLY_TYPE_FLOAT32: { float v;    memcpy(&v, raw, sizeof(v)); *value = v; break; }
+    default:               { double v;   memcpy(&v, raw, sizeof(v)); *value = v; break; }
+    }
+    return 1;
+}
+
+/**
+ * @brief Parse the vertex and face elements of a PLY file, skipping all others
+ */
+static int parsePly(const char* data, size_t size, Mesh* mesh,
+                    int* vertexCount, int* triangleCount, const char** error)
+{
+    PlyHeader header;
+    if (parsePlyHeader(data, size, &header, error) != ALLOCATION_SUCCESS) {
+        return ALLOCATION_FAILURE;
+    }
+
+    PlyReader reader = {header.body, data + size, header.format};
+    long vertices = -1;
+    int triangles = 0;
+
+    for (int e = 0; e < header.elementCount; e++) {
+        const PlyElement* element = &header.elements[e];
+
+        if (element->isVertex) {
+            int axes = 0;
+            for (int p = 0; p < element->propertyCount; p++) {
+                axes |= element->properties[p].role == PLY_ROLE_X ? 1
+                      : element->properties[p].role == PLY_ROLE_Y ? 2
+                      : element->properties[p].role == PLY_ROLE_Z ? 4 : 0;
+            }
+            if (vertices >= 0 || axes != 7 || element->count > MESH_MAX_VERTICES) {
+                *error = vertices >= 0 ? "more than one PLY vertex element"
+                       : axes != 7 ? "PLY vertices without x, y and z" : "too many vertices";
+                return ALLOCATION_FAILURE;
+            }
+            vertices = element->count;
+        }
+        if (element->isFace && vertices < 0) {
+            *error = "PLY faces before vertices";
+            return ALLOCATION_FAILURE;
+        }
+
+        /* Positions are only stored while filling; counting only walks the data */
+        for (long item = 0; item < element->count; item++) {
+            for (int p = 0; p < element->propertyCount; p++) {
+                const PlyProperty* property = &element->properties[p];
+                double value;
+
+                if (property->countType == PLY_TYPE_NONE) {
+                    if (!readPlyValue(&reader, property->type, &value)) {
+                        *error = "truncated or malformed PLY data";
+                        return ALLOCATION_FAILURE;
+                    }
+                    if (element->isVertex && property->role != PLY_ROLE_OTHER) {
+                        if (!isfinite((float)value)) {
+                            *error = "malformed vertex";
+                            return ALLOCATION_FAILURE;
+                        }
+                        if (mesh != NULL) {
+                            float* axis = property->role == PLY_ROLE_X ? mesh->x
+                                        : property->role == PLY_ROLE_Y ? mesh->y : mesh->z;
+                            axis[item] = (float)value;
+                        }
+                    }
+                    continue;
+                }
+
+                double length;
+                if (!readPlyValue(&reader, property->countType, &length) || length < 0.0) {
+                    *error = "truncated or malformed PLY data";
+                    return ALLOCATION_FAILURE;
+                }
+
+                int first = 0, previous = 0;
+                for (long corner = 0; corner < (long)length; corner++) {
+                    if (!readPlyValue(&reader, property->type, &value)) {
+                        *error = "truncated or malformed PLY data";
+                        return ALLOCATION_FAILURE;
+                    }
+                    if (property->role != PLY_ROLE_INDICES) {
+                        continue;
+                    }
+                    if (!(value >= 0.0 && value < (double)vertices)) {
+                        *error = "face references a missing vertex";
+                        return ALLOCATION_FAILURE;
+                    }
+
+                    /* Split polygons into a fan around the first corner */
+                    const int vertex = (int)value;
+                    if (corner >= 2) {
+                        if (triangles >= MESH_MAX_TRIANGLES) {
+                            *error = "too many triangles";
+                            return ALLOCATION_FAILURE;
+                        }
+                        if (mesh != NULL) {
+                            int* triangle = mesh->indices + 3 * (size_t)triangles;
+                            triangle[0] = first;
+                            triangle[1] = previous;
+                            triangle[2] = vertex;
+                        }
+                        triangles++;
+                    }
+                    first = corner == 0 ? vertex : first;
+                    previous = vertex;
+                }
+            }
+        }
+    }
+
+    *vertexCount = vertices > 0 ? (int)vertices : 0;
+    *triangleCount = triangles;
+    return ALLOCATION_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Loading and geometry                                                       */
+/* -------------------------------------------------------------------------- */
+
+int loadMesh(Mesh* mesh, const char* path)
+{
+    if (mesh == NULL || path == NULL) {
+        return ALLOCATION_FAILURE;
+    }
+    memset(mesh, 0, sizeof(*mesh));
+
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "Error: cannot open mesh '%s': %s\n", path, strerror(errno));
+        return ALLOCATION_FAILURE;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size <= 0) {
+        fprintf(stderr, "Error: cannot load mesh '%s': empty or unreadable file\n", path);
+        close(fd);
+        return ALLOCATION_FAILURE;
+    }
+
+    /* The mapping stays valid after the descriptor is closed */
+    const size_t size = (size_t)status.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Error: cannot map mesh '%s': %s\n", path, strerror(errno));
+        return ALLOCATION_FAILURE;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    const char* data = (const char*)mapping;
+    const int isPly = size >= 4 && memcmp(data, "ply", 3) == 0 && (data[3] == '\n' || data[3] == '\r');
+    const MeshParser parse = isPly ? parsePly : parseObj;
+
+    const char* error = "no triangles";
+    int vertexCount = 0, triangleCount = 0;
+    int result = parse(data, size, NULL, &vertexCount, &triangleCount, &error);
+    if (result == ALLOCATION_SUCCESS && (vertexCount == 0 || triangleCount == 0)) {
+        result = ALLOCATION_FAILURE;
+    }
+    if (result == ALLOCATION_SUCCESS) {
+        result = initializeMesh(mesh, vertexCount, triangleCount, 0);
+        error = "out of memory";
+    }
+    if (result == ALLOCATION_SUCCESS) {
+        result = parse(data, size, mesh, &vertexCount, &triangleCount, &error);
+    }
+    munmap(mapping, size);
+
+    if (result != ALLOCATION_SUCCESS) {
+        fprintf(stderr, "Error: cannot load mesh '%s': %s\n", path, error);
+        destroyMesh(mesh);
+        return ALLOCATION_FAILURE;
+    }
+
+    updateMeshNormals(mesh);
+    return ALLOCATION_SUCCESS;
+}
+
+void updateMeshNormals(Mesh* mesh)
+{
+    if (mesh == NULL || mesh->block == NULL) {
+        return;
+    }
+
+    for (int triangle = 0; triangle < mesh->triangleCount; triangle++) {
+        const int* corner = mesh->indices + 3 * (size_t)triangle;
+        const float ax = mesh->x[corner[0]], ay = mesh->y[corner[0]], az = mesh->z[corner[0]];
+        const float ux = mesh->x[corner[1]] - ax, uy = mesh->y[corner[1]] - ay, uz = mesh->z[corner[1]] - az;
+        const float vx = mesh->x[corner[2]] - ax, vy = mesh->y[corner[2]] - ay, vz = mesh->z[corner[2]] - az;
+
+        float nx = uy * vz - uz * vy;
+        float ny = uz * vx - ux * vz;
+        float nz = ux * vy - uy * vx;
+        const float length = sqrtf(nx * nx + ny * ny + nz * nz);
+
+        /* Degenerate triangles keep a zero normal and shade as facing away */
+        if (length > 0.0f) {
+            nx /= length;
+            ny /= length;
+            nz /= length;
+        }
+        mesh->normalX[triangle] = nx;
+        mesh->normalY[triangle] = ny;
+        mesh->normalZ[triangle] = nz;
+    }
+}
+
+void fitMesh(Mesh* mesh, float halfExtent)
+{
+    if (mesh == NULL || mesh->block == NULL) {
+        return;
+    }
+
+    float minimum[3] = {INFINITY, INFINITY, INFINITY};
+    float maximum[3] = {-INFINITY, -INFINITY, -INFINITY};
+    float* const axes[3] = {mesh->x, mesh->y, mesh->z};
+    for (int axis = 0; axis < 3; axis++) {
+        for (int vertex = 0; vertex < mesh->vertexCount; vertex++) {
+            minimum[axis] = fminf(minimum[axis], axes[axis][vertex]);
+            maximum[axis] = fmaxf(maximum[axis], axes[axis][vertex]);
+        }
+    }
+
+    float largest = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        largest = fmaxf(largest, 0.5f * (maximum[axis] - minimum[axis]));
+    }
+    const float scale = largest > 0.0f ? halfExtent / largest : 1.0f;
+
+    /* A uniform scale and a translation leave the normals unchanged */
+    for (int axis = 0; axis < 3; axis++) {
+        const float center = 0.5f * (minimum[axis] + maximum[axis]);
+        for (int vertex = 0; vertex < mesh->vertexCount; vertex++) {
+            axes[axis][vertex] = (axes[axis][vertex] - center) * scale;
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Rendering                                                                  */
+/* -------------------------------------------------------------------------- */
+
+/** Tile span of a triangle that covers no cell */
+#define MESH_TILE_SPAN_NONE UINT32_MAX
+
+/** Tiles renderTiled() splits the largest window into */
+#define MESH_MAX_TILES (((MAX_WINDOW_WIDTH + RENDER_TILE_WIDTH - 1) / RENDER_TILE_WIDTH) * \
+                        ((MAX_WINDOW_HEIGHT + RENDER_TILE_HEIGHT - 1) / RENDER_TILE_HEIGHT))
+
+/**
+ * @brief Per-frame mesh state shared by the pool threads and render tiles
+ */
+typedef struct
+{
+    RenderContext* context;             /**< Context rendered into */
+    Mesh* mesh;                         /**< Mesh drawn; receives the projected vertices */
+    Transform3D transform;              /**< Rotation for this frame */
+    Projection3D projection;            /**< Projection of the context */
+    TriangleBatch batch;                /**< The projected triangles, read by every tile */
+    int binned;                         /**< Tiles draw only their bin of triangles */
+    int tileColumns;                    /**< Tiles per row of the window */
+    int binStart[MESH_MAX_TILES + 1];   /**< Offsets of each tile's bin in mesh->tileBins */
+} MeshFrame;
+
+void projectMeshVertices(const Mesh* mesh, const Transform3D* transform, float scale, Point3D offset,
+                         const Projection3D* projection, int begin, int end,
+                         float* screenX, float* screenY, float* inverseDepth)
+{
+    for (int vertex = begin; vertex < end; vertex++) {
+        const Point3D point = {mesh->x[vertex], mesh->y[vertex], mesh->z[vertex]};
+        const Point3D rotated = transformPoint(transform, point);
+        const float depth = rotated.z * scale + offset.z + projection->viewerDistance;
+
+        if (!(depth > 0.0f)) {
+            screenX[vertex] = -1.0f;
+            screenY[vertex] = -1.0f;
+            inverseDepth[vertex] = 0.0f;
+            continue;
+        }
+
+        const float oneOverDepth = 1.0f / depth;
+        screenX[vertex] = projection->centerX + projection->scaleX * oneOverDepth * (rotated.x * scale + offset.x);
+        screenY[vertex] = projection->centerY + projection->scaleY * oneOverDepth * (rotated.y * scale + offset.y);
+        inverseDepth[vertex] = oneOverDepth;
+    }
+}
+
+void shadeMeshTriangles(const Mesh* mesh, const Transform3D* transform, int begin, int end, char* shading)
+{
+    /* The viewer looks along +z, so a triangle faces it as its rotated normal's z goes to -1 */
+    static const char ramp[] = MESH_SHADE_RAMP;
+    const int steps = (int)sizeof(ramp) - 2;
+    const float* row = transform->m[2];
+    for (int triangle = begin; triangle < end; triangle++) {
+        const float facing = -(row[0] * mesh->normalX[triangle] + row[1] * mesh->normalY[triangle] +
+                               row[2] * mesh->normalZ[triangle]);
+        const int level = facing > 0.0f ? (int)(facing * (float)steps + 0.5f) : 0;
+        shading[triangle] = ramp[level < steps ? level : steps];
+    }
+}
+
+/**
+ * @brief Project vertices [vertexBegin, vertexEnd) and shade triangles [triangleBegin, triangleEnd)
+ */
+static void transformMeshRange(const MeshFrame* frame, int vertexBegin, int vertexEnd,
+                               int triangleBegin, int triangleEnd)
+{
+    Mesh* mesh = frame->mesh;
+    projectMeshVertices(mesh, &frame->transform, 1.0f, (Point3D){0.0f, 0.0f, 0.0f}, &frame->projection,
+                        vertexBegin, vertexEnd, mesh->screenX, mesh->screenY, mesh->inverseDepth);
+    if (mesh->glyphs == NULL) {
+        shadeMeshTriangles(mesh, &frame->transform, triangleBegin, triangleEnd, mesh->shading);
+    }
+}
+
+/**
+ * @brief Pool task: transform an equal share of the vertices and triangles
+ */
+static void transformMeshTask(void* data, int threadIndex, int threadCount)
+{
+    const MeshFrame* frame = (const MeshFrame*)data;
+    const long vertices = frame->mesh->vertexCount, triangles = frame->mesh->triangleCount;
+    transformMeshRange(frame,
+                       (int)(vertices * threadIndex / threadCount), (int)(vertices * (threadIndex + 1) / threadCount),
+                       (int)(triangles * threadIndex / threadCount), (int)(triangles * (threadIndex + 1) / threadCount));
+}
+
+/**
+ * @brief ceilf() for values in [0, INT_MAX] without the library call
+ */
+static inline int ceilNonNegative(float value)
+{
+    const int truncated = (int)value;
+    return truncated + ((float)truncated < value);
+}
+
+/**
+ * @brief Find the tiles whose cell centers a projected triangle may cover
+ *
+ * @return The inclusive tile range packed as x0 | x1 << 8 | y0 << 16 | y1 << 24,
+ *         or MESH_TILE_SPAN_NONE if the triangle cannot produce a cell
+ *         (behind the viewer, off screen, between cell centers or culled)
+ */
+static uint32_t findTriangleTiles(const MeshFrame* frame, int triangle)
+{
+    const Mesh* mesh = frame->mesh;
+    const int* corner = mesh->indices + 3 * (size_t)triangle;
+    const float* x = mesh->screenX;
+    const float* y = mesh->screenY;
+    if (!(mesh->inverseDepth[corner[0]] > 0.0f && mesh->inverseDepth[corner[1]] > 0.0f &&
+          mesh->inverseDepth[corner[2]] > 0.0f)) {
+        return MESH_TILE_SPAN_NONE;
+    }
+
+    /* Same cell-center bounds as the scan conversion, clamped to the window;
+     * plain compares, as fminf()/fmaxf() are library calls */
+    float minX = x[corner[0]], maxX = minX, minY = y[corner[0]], maxY = minY;
+    for (int i = 1; i < 3; i++) {
+        minX = x[corner[i]] < minX ? x[corner[i]] : minX;
+        maxX = x[corner[i]] > maxX ? x[corner[i]] : maxX;
+        minY = y[corner[i]] < minY ? y[corner[i]] : minY;
+        maxY = y[corner[i]] > maxY ? y[corner[i]] : maxY;
+    }
+    const float width = (float)frame->context->windowWidth, height = (float)frame->context->windowHeight;
+    if (maxX < 0.5f || minX > width - 0.5f || maxY < 0.5f || minY > height - 0.5f) {
+        return MESH_TILE_SPAN_NONE;
+    }
+    const int firstColumn = minX > 0.5f ? ceilNonNegative(minX - 0.5f) : 0;
+    const int lastColumn = maxX < width - 0.5f ? ceilNonNegative(maxX - 0.5f) - 1 : (int)width - 1;
+    const int firstRow = minY > 0.5f ? ceilNonNegative(minY - 0.5f) : 0;
+    const int lastRow = maxY < height - 0.5f ? ceilNonNegative(maxY - 0.5f) - 1 : (int)height - 1;
+    if (firstColumn > lastColumn || firstRow > lastRow) {
+        return MESH_TILE_SPAN_NONE;
+    }
+
+    if (mesh->backFaceCulling) {
+        const float area = (x[corner[1]] - x[corner[0]]) * (y[corner[2]] - y[corner[0]]) -
+                           (x[corner[2]] - x[corner[0]]) * (y[corner[1]] - y[corner[0]]);
+        if (area > 0.0f) {
+            return MESH_TILE_SPAN_NONE;
+        }
+    }
+
+    return (uint32_t)(firstColumn / RENDER_TILE_WIDTH) | (uint32_t)(lastColumn / RENDER_TILE_WIDTH) << 8 |
+           (uint32_t)(firstRow / RENDER_TILE_HEIGHT) << 16 | (uint32_t)(lastRow / RENDER_TILE_HEIGHT) << 24;
+}
+
+/**
+ * @brief Pool task: find the tile spans of an equal share of the triangles
+ */
+static void findTileSpansTask(void* data, int threadIndex, int threadCount)
+{
+    const MeshFrame* frame = (const MeshFrame*)data;
+    const long triangles = frame->mesh->triangleCount;
+    const int end = (int)(triangles * (threadIndex + 1) / threadCount);
+    for (int triangle = (int)(triangles * threadIndex / threadCount); triangle < end; triangle++) {
+        frame->mesh->tileSpans[triangle] = findTriangleTiles(frame, triangle);
+    }
+}
+
+/**
+ * @brief Sort the triangles into per-tile bins (a counting sort over tiles)
+ *
+ * Without bins every tile would test every triangle of the mesh. The spans
+ * are found in parallel; the sort itself only streams over them. The bin
+ * storage only grows, so steady-state frames do not allocate.
+ *
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE if the bins cannot grow
+ */
+static int binMeshTriangles(MeshFrame* frame)
+{
+    Mesh* mesh = frame->mesh;
+    const RenderContext* context = frame->context;
+    frame->tileColumns = (context->windowWidth + RENDER_TILE_WIDTH - 1) / RENDER_TILE_WIDTH;
+    const int tileCount = frame->tileColumns * ((context->windowHeight + RENDER_TILE_HEIGHT - 1) / RENDER_TILE_HEIGHT);
+
+    runThreadPool(findTileSpansTask, frame);
+
+    int* counts = frame->binStart;
+    memset(counts, 0, sizeof(frame->binStart));
+    for (int triangle = 0; triangle < mesh->triangleCount; triangle++) {
+        const uint32_t span = mesh->tileSpans[triangle];
+        if (span == MESH_TILE_SPAN_NONE) {
+            continue;
+        }
+        for (uint32_t row = span >> 16 & 0xFFu; row <= span >> 24; row++) {
+            for (uint32_t column = span & 0xFFu; column <= (span >> 8 & 0xFFu); column++) {
+                counts[row * (uint32_t)frame->tileColumns + column + 1]++;
+            }
+        }
+    }
+    for (int tile = 0; tile < tileCount; tile++) {
+        counts[tile + 1] += counts[tile];
+    }
+
+    const size_t entries = (size_t)counts[tileCount];
+    if (entries > mesh->tileBinCapacity) {
+        int* grown = (int*)realloc(mesh->tileBins, entries * sizeof(int));
+        if (grown == NULL) {
+            return ALLOCATION_FAILURE;
+        }
+        mesh->tileBins = grown;
+        mesh->tileBinCapacity = entries;
+    }
+
+    /* Fill in triangle order; binStart[tile] ends up at the start of bin tile + 1 */
+    for (int triangle = 0; triangle < mesh->triangleCount; triangle++) {
+        const uint32_t span = mesh->tileSpans[triangle];
+        if (span == MESH_TILE_SPAN_NONE) {
+            continue;
+        }
+        for (uint32_t row = span >> 16 & 0xFFu; row <= span >> 24; row++) {
+            for (uint32_t column = span & 0xFFu; column <= (span >> 8 & 0xFFu); column++) {
+                mesh->tileBins[counts[row * (uint32_t)frame->tileColumns + column]++] = triangle;
+            }
+        }
+    }
+    memmove(counts + 1, counts, (size_t)tileCount * sizeof(int));
+    counts[0] = 0;
+    return ALLOCATION_SUCCESS;
+}
+
+/**
+ * @brief Rasterize the triangles overlapping one render tile
+ */
+static void drawMeshRegion(void* data, const RenderTarget* target)
+{
+    const MeshFrame* frame = (const MeshFrame*)data;
+    TriangleBatch batch = frame->batch;
+
+    /* renderTiled() hands out tiles on the RENDER_TILE_WIDTH x RENDER_TILE_HEIGHT grid */
+    if (frame->binned) {
+        const int tile = (target->clip.y0 / RENDER_TILE_HEIGHT) * frame->tileColumns +
+                         target->clip.x0 / RENDER_TILE_WIDTH;
+        batch.order = frame->mesh->tileBins + frame->binStart[tile];
+        batch.count = frame->binStart[tile + 1] - frame->binStart[tile];
+    }
+    rasterizeTriangles(frame->context, &batch, target);
+}
+
+void drawMesh(RenderContext* context, Mesh* mesh, Rotation3D rotation)
+{
+    if (context == NULL || mesh == NULL || mesh->block == NULL) {
+        return;
+    }
+
+    /* Every vertex is projected once, however many triangles share it */
+    MeshFrame frame;
+    frame.context = context;
+    frame.mesh = mesh;
+    frame.transform = buildRotationTransform(rotation);
+    frame.projection = getRendererProjection(context);
+    if (getThreadPoolSize() > 1) {
+        runThreadPool(transformMeshTask, &frame);
+    } else {
+        transformMeshRange(&frame, 0, mesh->vertexCount, 0, mesh->triangleCount);
+    }
+
+    frame.batch.x = mesh->screenX;
+    frame.batch.y = mesh->screenY;
+    frame.batch.inverseDepth = mesh->inverseDepth;
+    frame.batch.indices = mesh->indices;
+    frame.batch.glyphs = mesh->glyphs != NULL ? mesh->glyphs : mesh->shading;
+    frame.batch.glyph = context->backgroundChar;
+    frame.batch.order = NULL;
+    frame.batch.count = mesh->triangleCount;
+    frame.batch.cullBackFaces = mesh->backFaceCulling;
+
+    /* A single full-window pass needs no bins; if they cannot grow, tiles fall back to all triangles */
+    frame.binned = getThreadPoolSize() > 1 && binMeshTriangles(&frame) == ALLOCATION_SUCCESS;
+
+    renderTiled(context, drawMeshRegion, &frame);
+    resolveFrameBuffer(context);
+}
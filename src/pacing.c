@@ -0,0 +1,141 @@
+/**
+ * @file pacing.c
+ * @author D. Heger
+ * @brief Frame pacing implementation
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pacing.h"
+
+#define NSEC_PER_SECOND 1000000000LL
+
+static long long periodNs = 0;
+static long long deadlineNs = 0;    /* CLOCK_MONOTONIC nanoseconds */
+
+/* Lateness samples in a ring, plus counters over all frames */
+static float latenessSamples[PACING_SAMPLE_CAPACITY];
+static float sortedSamples[PACING_SAMPLE_CAPACITY];
+static long frameCount = 0;
+static long missedDeadlines = 0;
+static long periodsSkipped = 0;
+static double latenessSumMs = 0.0;
+static double maxLatenessMs = 0.0;
+
+static long long readMonotonicNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * NSEC_PER_SECOND + now.tv_nsec;
+}
+
+static struct timespec toTimespec(long long nanoseconds)
+{
+    struct timespec time;
+    time.tv_sec = (time_t)(nanoseconds / NSEC_PER_SECOND);
+    time.tv_nsec = (long)(nanoseconds % NSEC_PER_SECOND);
+    return time;
+}
+
+int initializeFramePacer(int targetFps)
+{
+    struct timespec now;
+    if (targetFps < 1 || targetFps > MAX_TARGET_FPS || clock_gettime(CLOCK_MONOTONIC, &now) != 0) {
+        return ALLOCATION_FAILURE;
+    }
+
+    periodNs = NSEC_PER_SECOND / targetFps;
+    deadlineNs = (long long)now.tv_sec * NSEC_PER_SECOND + now.tv_nsec + periodNs;
+
+    frameCount = 0;
+    missedDeadlines = 0;
+    periodsSkipped = 0;
+    latenessSumMs = 0.0;
+    maxLatenessMs = 0.0;
+    return ALLOCATION_SUCCESS;
+}
+
+struct timespec getFrameDeadline(void)
+{
+    return toTimespec(deadlineNs);
+}
+
+void waitForFrameDeadline(void)
+{
+    const struct timespec deadline = toTimespec(deadlineNs);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+    }
+}
+
+void beginPacedFrame(void)
+{
+    if (periodNs <= 0) {
+        return; /* Pacer not initialized */
+    }
+
+    const long long now = readMonotonicNs();
+    const long long lateNs = now > deadlineNs ? now - deadlineNs : 0;
+    const double lateMs = (double)lateNs / 1e6;
+
+    latenessSamples[frameCount % PACING_SAMPLE_CAPACITY] = (float)lateMs;
+    frameCount++;
+    latenessSumMs += lateMs;
+    if (lateMs > maxLatenessMs) {
+        maxLatenessMs = lateMs;
+    }
+    if (lateNs >= periodNs) {
+        missedDeadlines++;
+    }
+
+    /* Keep the schedule so short overruns are caught up, but not unbounded */
+    deadlineNs += periodNs;
+    const long long behind = (now - deadlineNs) / periodNs;
+    if (behind > PACING_MAX_CATCHUP_FRAMES) {
+        deadlineNs += behind * periodNs;
+        periodsSkipped += (long)behind;
+    }
+}
+
+static int compareFloatAscending(const void* lhs, const void* rhs)
+{
+    const float a = *(const float*)lhs;
+    const float b = *(const float*)rhs;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Linearly interpolated percentile of sorted samples
+ */
+static double sortedPercentile(const float* sorted, size_t count, double percentile)
+{
+    const double position = percentile / 100.0 * (double)(count - 1);
+    const size_t lower = (size_t)position;
+    const size_t upper = lower + 1 < count ? lower + 1 : lower;
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (position - (double)lower);
+}
+
+FramePacingStats getFramePacingStats(void)
+{
+    FramePacingStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.frames = frameCount;
+    stats.missedDeadlines = missedDeadlines;
+    stats.periodsSkipped = periodsSkipped;
+    if (frameCount == 0) {
+        return stats;
+    }
+
+    const size_t count = frameCount < PACING_SAMPLE_CAPACITY ? (size_t)frameCount : PACING_SAMPLE_CAPACITY;
+    memcpy(sortedSamples, latenessSamples, count * sizeof(float));
+    qsort(sortedSamples, count, sizeof(float), compareFloatAscending);
+
+    stats.meanLatenessMs = latenessSumMs / (double)frameCount;
+    stats.p50LatenessMs = sortedPercentile(sortedSamples, count, 50.0);
+    stats.p95LatenessMs = sortedPercentile(sortedSamples, count, 95.0);
+    stats.p99LatenessMs = sortedPercentile(sortedSamples, count, 99.0);
+    stats.maxLatenessMs = maxLatenessMs;
+    return stats;
+}
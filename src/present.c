@@ -0,0 +1,583 @@
+/**
+ * @file present.c
+ * @author D. Heger
+ * @brief Terminal presentation implementation
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include "present.h"
+#include "context.h"
+
+int presentDeltaEncoding = 1;
+
+/* Sections of the presented context's arena sized for the largest supported
+ * window, reused every frame (see bindArenaBuffers()) */
+static char* outputBuffer = NULL;
+
+/* The frame currently on screen; 0 x 0 means unknown */
+static char* previousFrame = NULL;
+static int previousWidth = 0;
+static int previousHeight = 0;
+static RenderRect previousDrawn = {0, 0, 0, 0};
+static int previousDrawnKnown = 0;      /* Whether previousDrawn bounds its non-background cells */
+static int screenInvalidated = 0;       /* Atomic; set by resetPresentation() */
+
+static PresentStats presentStats = {0L, 0L, 0L, 0L, 0L, 0L};
+
+/* Non-blocking output: a private description of the output, and the bytes
+ * of outputBuffer it has not accepted yet */
+static int nonBlockingFd = -1;
+static size_t pendingOffset = 0;
+static size_t pendingLength = 0;
+
+/**
+ * @brief One preallocated frame handed from the render to the present thread
+ */
+typedef struct
+{
+    int width;
+    int height;
+    RenderRect drawn;
+    RenderArena arena;      /* Arena of the context the frame came from */
+    char cells[MAX_WINDOW_WIDTH * MAX_WINDOW_HEIGHT];
+} PresentSlot;
+
+/*
+ * Triple buffer: the render thread owns one slot, the present thread another,
+ * and the third is published. Each side swaps its slot for the published one
+ * with a single atomic exchange, so neither ever waits on the other. The
+ * fresh flag marks a published frame not yet presented; a newer frame
+ * replaces it, so the present thread always sends the newest frame.
+ */
+enum { PRESENT_SLOT_COUNT = 3, PRESENT_SLOT_FRESH = 4 };
+static PresentSlot presentSlots[PRESENT_SLOT_COUNT];
+static int renderSlot = 0;              /* Owned by the render thread */
+static int presentSlot = 1;             /* Owned by the present thread */
+static int publishedSlot __attribute__((aligned(64))) = 2;     /* Atomic; slot index | PRESENT_SLOT_FRESH */
+
+static pthread_t presenterThread;
+static sem_t framesReady;               /* Wakes the present thread; not part of the handoff */
+static int presenterFd = -1;
+static int presenterRunning = 0;        /* Owned by the render thread */
+static int presenterStopping = 0;       /* Atomic */
+static int presenterFailed = 0;         /* Atomic */
+
+/**
+ * @brief Validate frame dimensions against supported limits
+ */
+static int isValidFrameSize(int width, int height)
+{
+    return width > 0 && width <= MAX_WINDOW_WIDTH && height > 0 && height <= MAX_WINDOW_HEIGHT;
+}
+
+static int presentCells(int fd, const RenderArena* arena, const char* frame, int width, int height,
+                        const RenderRect* drawn);
+
+size_t encodeFrame(const char* frame, int width, int height, char* output)
+{
+    if (frame == NULL || output == NULL || !isValidFrameSize(width, height)) {
+        return 0;
+    }
+
+    size_t length = sizeof(HOME_CURSOR_SEQ) - 1;
+    memcpy(output, HOME_CURSOR_SEQ, length);
+
+    for (int row = 0; row < height; row++) {
+        output[length++] = '\n';
+        memcpy(output + length, frame + (size_t)row * width + 1, (size_t)width - 1);
+        length += (size_t)width - 1;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Number of decimal digits of a non-negative value below 1000
+ */
+static size_t digitCount(int value)
+{
+    return value >= 100 ? 3 : value >= 10 ? 2 : 1;
+}
+
+/**
+ * @brief Append a CSI sequence with one or two numeric parameters
+ *
+ * @param second Second parameter, or -1 for none
+ * @return Bytes appended
+ */
+static size_t appendEscape(char* output, int first, int second, char final)
+{
+    size_t length = 0;
+    output[length++] = '\x1b';
+    output[length++] = '[';
+
+    const int values[2] = {first, second};
+    for (int i = 0; i < 2 && values[i] >= 0; i++) {
+        if (i > 0) {
+            output[length++] = ';';
+        }
+        const size_t digits = digitCount(values[i]);
+        for (size_t d = digits, value = (size_t)values[i]; d > 0; d--, value /= 10) {
+            output[length + d - 1] = (char)('0' + value % 10);
+        }
+        length += digits;
+    }
+
+    output[length++] = final;
+    return length;
+}
+
+int encodeFrameDelta(const char* frame, const char* previous, int width, int height,
+                     const RenderRect* region, char* output, size_t limit, size_t* length)
+{
+    if (frame == NULL || previous == NULL || output == NULL || length == NULL ||
+        !isValidFrameSize(width, height)) {
+        return 0;
+    }
+
+    /* Column 0 holds the newline and is never displayed */
+    int firstRow = 0, lastRow = height, firstColumn = 1, lastColumn = width;
+    if (region != NULL) {
+        firstRow = region->y0 > 0 ? region->y0 : 0;
+        lastRow = region->y1 < height ? region->y1 : height;
+        firstColumn = region->x0 > 1 ? region->x0 : 1;
+        lastColumn = region->x1 < width ? region->x1 : width;
+    }
+
+    /* Longest escape: ESC [ row ; column H with three-digit numbers */
+    enum { MAX_ESCAPE_LENGTH = 10 };
+    size_t used = 0;
+
+    for (int row = firstRow; row < lastRow; row++) {
+        const char* current = frame + (size_t)row * width;
+        const char* before = previous + (size_t)row * width;
+        int cursor = -1;    /* Cell the cursor sits on within this row, -1 if elsewhere */
+
+        /* Cell (row, column) is shown at terminal line row + 2, column column */
+        for (int column = firstColumn; column < lastColumn; column++) {
+            if (current[column] == before[column]) {
+                continue;
+            }
+
+            if (used + MAX_ESCAPE_LENGTH + (size_t)(column - (cursor > 0 ? cursor : column)) + 1 > limit) {
+                return 0;
+            }
+
+            if (cursor < 0) {
+                used += appendEscape(output + used, row + 2, column, 'H');
+            } else if (cursor < column) {
+                /* Resend the unchanged gap if that is no longer than skipping it */
+                const int gap = column - cursor;
+                if ((size_t)gap <= 3 + digitCount(gap)) {
+                    memcpy(output + used, current + cursor, (size_t)gap);
+                    used += (size_t)gap;
+                } else {
+                    used += appendEscape(output + used, gap, -1, 'C');
+                }
+            }
+
+            output[used++] = current[column];
+            cursor = column + 1;
+        }
+    }
+
+    *length = used;
+    return 1;
+}
+
+void resetPresentation(void)
+{
+    __atomic_store_n(&screenInvalidated, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Present thread: send the newest published frame each time it wakes
+ */
+static void* presenterMain(void* argument)
+{
+    (void)argument;
+
+    for (;;) {
+        while (sem_wait(&framesReady) != 0 && errno == EINTR) {
+        }
+        const int stopping = __atomic_load_n(&presenterStopping, __ATOMIC_ACQUIRE);
+
+        /* Only the present thread clears the flag, so a fresh slot stays fresh until the exchange */
+        if (__atomic_load_n(&publishedSlot, __ATOMIC_RELAXED) & PRESENT_SLOT_FRESH) {
+            presentSlot = __atomic_exchange_n(&publishedSlot, presentSlot, __ATOMIC_ACQ_REL) & ~PRESENT_SLOT_FRESH;
+            const PresentSlot* slot = &presentSlots[presentSlot];
+
+            if (!__atomic_load_n(&presenterFailed, __ATOMIC_RELAXED) &&
+                presentCells(presenterFd, &slot->arena, slot->cells, slot->width, slot->height,
+                             &slot->drawn) != ALLOCATION_SUCCESS) {
+                __atomic_store_n(&presenterFailed, 1, __ATOMIC_RELAXED);
+            }
+        }
+
+        if (stopping) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+int startPresenter(int fd)
+{
+    stopPresenter();
+
+    if (sem_init(&framesReady, 0, 0) != 0) {
+        return ALLOCATION_FAILURE;
+    }
+
+    presenterFd = fd;
+    renderSlot = 0;
+    presentSlot = 1;
+    publishedSlot = 2;
+    presenterStopping = 0;
+    presenterFailed = 0;
+
+    if (pthread_create(&presenterThread, NULL, presenterMain, NULL) != 0) {
+        sem_destroy(&framesReady);
+        return ALLOCATION_FAILURE;
+    }
+
+    presenterRunning = 1;
+    return ALLOCATION_SUCCESS;
+}
+
+int submitFrame(const RenderContext* context)
+{
+    if (!presenterRunning || context == NULL || context->frameBuffer == NULL ||
+        !isValidFrameSize(context->windowWidth, context->windowHeight) ||
+        __atomic_load_n(&presenterFailed, __ATOMIC_RELAXED)) {
+        return ALLOCATION_FAILURE;
+    }
+    const int width = context->windowWidth, height = context->windowHeight;
+
+    PresentSlot* slot = &presentSlots[renderSlot];
+    slot->width = width;
+    slot->height = height;
+    slot->drawn = getRendererDrawnRect(context);
+    slot->arena = getRendererArena(context);
+    memcpy(slot->cells, context->frameBuffer, (size_t)width * height);
+
+    const int previous = __atomic_exchange_n(&publishedSlot, renderSlot | PRESENT_SLOT_FRESH, __ATOMIC_ACQ_REL);
+    renderSlot = previous & ~PRESENT_SLOT_FRESH;
+    if (previous & PRESENT_SLOT_FRESH) {
+        /* The terminal is behind: this frame replaced one never presented, whose wakeup is still due */
+        __atomic_fetch_add(&presentStats.framesDropped, 1L, __ATOMIC_RELAXED);
+    } else {
+        sem_post(&framesReady);
+    }
+    return ALLOCATION_SUCCESS;
+}
+
+void stopPresenter(void)
+{
+    if (!presenterRunning) {
+        return;
+    }
+
+    __atomic_store_n(&presenterStopping, 1, __ATOMIC_RELEASE);
+    sem_post(&framesReady);
+    pthread_join(presenterThread, NULL);
+    sem_destroy(&framesReady);
+    presenterRunning = 0;
+}
+
+PresentStats getPresentStats(void)
+{
+    return presentStats;
+}
+
+/**
+ * @brief Write all bytes, retrying after signals and partial writes
+ */
+static int writeAll(int fd, const char* data, size_t length)
+{
+    while (length > 0) {
+        const ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ALLOCATION_FAILURE;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return ALLOCATION_SUCCESS;
+}
+
+/**
+ * @brief Smallest rectangle containing both a and b, ignoring empty ones
+ */
+static RenderRect unionRect(RenderRect a, RenderRect b)
+{
+    if (a.x0 >= a.x1 || a.y0 >= a.y1) {
+        return b;
+    }
+    if (b.x0 >= b.x1 || b.y0 >= b.y1) {
+        return a;
+    }
+
+    RenderRect result;
+    result.x0 = a.x0 < b.x0 ? a.x0 : b.x0;
+    result.y0 = a.y0 < b.y0 ? a.y0 : b.y0;
+    result.x1 = a.x1 > b.x1 ? a.x1 : b.x1;
+    result.y1 = a.y1 > b.y1 ? a.y1 : b.y1;
+    return result;
+}
+
+/**
+ * @brief Point outputBuffer and previousFrame at a context's arena
+ *
+ * @return 1 if the arena is mapped, 0 otherwise
+ */
+static int bindArenaBuffers(const RenderArena* arena)
+{
+    if (arena->output == NULL || arena->previousFrame == NULL) {
+        return 0;
+    }
+
+    /* A new arena holds no copy of the screen */
+    if (arena->previousFrame != previousFrame) {
+        previousWidth = 0;
+        previousHeight = 0;
+        previousDrawnKnown = 0;
+    }
+    outputBuffer = arena->output;
+    previousFrame = arena->previousFrame;
+    return 1;
+}
+
+/**
+ * @brief Encode a frame against the screen contents and remember it as shown
+ *
+ * @param drawn Rectangle bounding the frame's non-background cells, or NULL
+ * @return Bytes placed in outputBuffer, 0 if nothing changed
+ */
+static size_t encodePresentedFrame(const char* frame, int width, int height, const RenderRect* drawn)
+{
+    /* An unknown screen (first frame, resize, failed write) is cleared first */
+    const int screenKnown = !__atomic_exchange_n(&screenInvalidated, 0, __ATOMIC_RELAXED) &&
+                            width == previousWidth && height == previousHeight;
+
+    /* Outside both frames' drawn rectangles the screen and the frame are background */
+    RenderRect region = {0, 0, width, height};
+    const int regionKnown = screenKnown && drawn != NULL && previousDrawnKnown;
+    if (regionKnown) {
+        region = unionRect(previousDrawn, *drawn);
+        region.x0 = region.x0 > 0 ? region.x0 : 0;
+        region.y0 = region.y0 > 0 ? region.y0 : 0;
+        region.x1 = region.x1 < width ? region.x1 : width;
+        region.y1 = region.y1 < height ? region.y1 : height;
+    }
+
+    /* A delta is only worth sending if it is strictly shorter than a redraw */
+    const size_t fullLength = sizeof(HOME_CURSOR_SEQ) - 1 + (size_t)width * height;
+    size_t length = 0;
+    if (presentDeltaEncoding && screenKnown &&
+        encodeFrameDelta(frame, previousFrame, width, height, &region, outputBuffer, fullLength - 1, &length)) {
+        presentStats.deltaFrames++;
+    } else {
+        if (!screenKnown) {
+            memcpy(outputBuffer, CLEAR_SCREEN_SEQ, sizeof(CLEAR_SCREEN_SEQ) - 1);
+            length = sizeof(CLEAR_SCREEN_SEQ) - 1;
+        }
+        length += encodeFrame(frame, width, height, outputBuffer + length);
+        presentStats.fullFrames++;
+    }
+
+    if (regionKnown) {
+        for (int row = region.y0; row < region.y1 && region.x0 < region.x1; row++) {
+            const size_t offset = (size_t)row * width + region.x0;
+            memcpy(previousFrame + offset, frame + offset, (size_t)(region.x1 - region.x0));
+        }
+    } else {
+        memcpy(previousFrame, frame, (size_t)width * height);
+    }
+    previousWidth = width;
+    previousHeight = height;
+    previousDrawnKnown = drawn != NULL;
+    if (drawn != NULL) {
+        previousDrawn = *drawn;
+    }
+    return length;
+}
+
+/**
+ * @brief Encode a frame into an arena's output buffer and write it in full
+ *
+ * @param drawn Rectangle bounding the frame's non-background cells, or NULL
+ */
+static int presentCells(int fd, const RenderArena* arena, const char* frame, int width, int height,
+                        const RenderRect* drawn)
+{
+    if (frame == NULL || !isValidFrameSize(width, height) || !bindArenaBuffers(arena)) {
+        return ALLOCATION_FAILURE;
+    }
+
+    const size_t length = encodePresentedFrame(frame, width, height, drawn);
+    if (length > 0 && writeAll(fd, outputBuffer, length) != ALLOCATION_SUCCESS) {
+        resetPresentation(); /* Screen contents are unknown after a failed write */
+        return ALLOCATION_FAILURE;
+    }
+    presentStats.bytesWritten += (long)length;
+    return ALLOCATION_SUCCESS;
+}
+
+/**
+ * @brief Send as much of the pending output as the fd accepts right now
+ *
+ * @return ALLOCATION_SUCCESS unless the write failed for a reason other
+ *         than a full output buffer
+ */
+static int flushPending(void)
+{
+    while (pendingLength > 0) {
+        const ssize_t written = write(nonBlockingFd, outputBuffer + pendingOffset, pendingLength);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            pendingLength = 0;
+            resetPresentation();
+            return ALLOCATION_FAILURE;
+        }
+        pendingOffset += (size_t)written;
+        pendingLength -= (size_t)written;
+        presentStats.bytesWritten += (long)written;
+    }
+    return ALLOCATION_SUCCESS;
+}
+
+/**
+ * @brief Open a non-blocking descriptor of fd's file that shares no file status flags with it
+ *
+ * On a terminal, fds 0, 1 and 2 usually share one open file description,
+ * so setting O_NONBLOCK on stdout would make stdin and stderr non-blocking
+ * too, and a crash would leave the shell a non-blocking terminal. Reopening
+ * the file gives a description of its own. Regular files never block, and
+ * reopening one would lose its offset, so they are only duplicated.
+ *
+ * @return The new fd (close-on-exec), or -1 if the file cannot be reopened
+ */
+static int openPrivateOutput(int fd)
+{
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        return -1;
+    }
+    if (S_ISREG(info.st_mode)) {
+        return fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    }
+
+    const int flags = O_WRONLY | O_NONBLOCK | O_CLOEXEC | O_NOCTTY;
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+    int privateFd = open(path, flags);
+    if (privateFd < 0 && isatty(fd)) {
+        const char* name = ttyname(fd);
+        privateFd = name != NULL ? open(name, flags) : -1;
+    }
+    return privateFd;
+}
+
+int startNonBlockingOutput(int fd)
+{
+    stopNonBlockingOutput();
+
+    const int privateFd = openPrivateOutput(fd);
+    if (privateFd < 0) {
+        return ALLOCATION_FAILURE;
+    }
+
+    nonBlockingFd = privateFd;
+    pendingOffset = 0;
+    pendingLength = 0;
+    return ALLOCATION_SUCCESS;
+}
+
+int presentFrame(int fd, const RenderContext* context)
+{
+    if (context == NULL) {
+        return ALLOCATION_FAILURE;
+    }
+
+    const RenderRect drawn = getRendererDrawnRect(context);
+    return presentCells(fd, &context->arena, context->frameBuffer, context->windowWidth, context->windowHeight,
+                        &drawn);
+}
+
+int presentFrameNonBlocking(const RenderContext* context)
+{
+    if (nonBlockingFd < 0 || context == NULL || context->frameBuffer == NULL ||
+        context->arena.output == NULL || !isValidFrameSize(context->windowWidth, context->windowHeight)) {
+        return ALLOCATION_FAILURE;
+    }
+
+    /* Finish the previous frame first; if it still does not fit, skip this one */
+    if (pendingLength > 0) {
+        if (flushPending() != ALLOCATION_SUCCESS) {
+            return ALLOCATION_FAILURE;
+        }
+        if (pendingLength > 0) {
+            presentStats.framesSkipped++;
+            return ALLOCATION_SUCCESS;
+        }
+    }
+
+    /* Do not queue more behind a terminal that is already far behind */
+    int queued = 0;
+    if (ioctl(nonBlockingFd, TIOCOUTQ, &queued) == 0 && queued > PRESENT_BACKLOG_LIMIT) {
+        presentStats.framesSkipped++;
+        return ALLOCATION_SUCCESS;
+    }
+
+    /* Pending bytes live in the previously bound arena, so switch only now */
+    bindArenaBuffers(&context->arena);
+    const RenderRect drawn = getRendererDrawnRect(context);
+    pendingOffset = 0;
+    pendingLength = encodePresentedFrame(context->frameBuffer, context->windowWidth, context->windowHeight,
+                                         &drawn);
+    if (flushPending() != ALLOCATION_SUCCESS) {
+        return ALLOCATION_FAILURE;
+    }
+    if (pendingLength > 0) {
+        presentStats.framesPartial++;
+    }
+    return ALLOCATION_SUCCESS;
+}
+
+void stopNonBlockingOutput(void)
+{
+    if (nonBlockingFd < 0) {
+        return;
+    }
+
+    /* Leave the terminal with a complete frame; only the private description blocks for it */
+    const int flags = fcntl(nonBlockingFd, F_GETFL, 0);
+    if (pendingLength > 0 && flags != -1 && fcntl(nonBlockingFd, F_SETFL, flags & ~O_NONBLOCK) == 0 &&
+        writeAll(nonBlockingFd, outputBuffer + pendingOffset, pendingLength) == ALLOCATION_SUCCESS) {
+        presentStats.bytesWritten += (long)pendingLength;
+    }
+
+    close(nonBlockingFd);
+    pendingLength = 0;
+    nonBlockingFd = -1;
+}
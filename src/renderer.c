@@ -9,20 +9,146 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <math.h>
+#include <sys/mman.h>
 #include "renderer.h"
+#include "context.h"
 #include "math3d.h"
+#include "present.h"
+#include "threadpool.h"
+#include "worksteal.h"
 
-/* Global rendering state variables */
-int windowWidth = DEFAULT_WINDOW_WIDTH;
-int windowHeight = DEFAULT_WINDOW_HEIGHT;
-int bufferSize = 0;
-float* zBuffer = NULL;
-char* frameBuffer = NULL;
-int backgroundChar = BACKGROUND_CHARACTER;
-int viewerDistance = DEFAULT_VIEWER_DISTANCE;
-float projectionScaleFactor = DEFAULT_PROJECTION_SCALE;
-int bufferIndex = 0;
+/* Outside a context's frameStaleRect and depthStaleRect its buffers are
+ * known to be cleared. drawnRect grows during the current frame and is
+ * extended with atomic min/max, since tiles and merge stripes mark it from
+ * several threads. */
+static const RenderRect emptyRect = {INT_MAX, INT_MAX, INT_MIN, INT_MIN};
+
+/**
+ * @brief Smallest rectangle containing both a and b (either may be empty)
+ */
+static RenderRect unionRect(RenderRect a, RenderRect b)
+{
+    RenderRect result;
+    result.x0 = a.x0 < b.x0 ? a.x0 : b.x0;
+    result.y0 = a.y0 < b.y0 ? a.y0 : b.y0;
+    result.x1 = a.x1 > b.x1 ? a.x1 : b.x1;
+    result.y1 = a.y1 > b.y1 ? a.y1 : b.y1;
+    return result;
+}
+
+/**
+ * @brief Report a rectangle to API callers, with empty ones as all zeroes
+ */
+static RenderRect publicRect(RenderRect rect)
+{
+    if (rect.x0 >= rect.x1 || rect.y0 >= rect.y1) {
+        const RenderRect none = {0, 0, 0, 0};
+        return none;
+    }
+    return rect;
+}
+
+static void atomicMin(int* value, int candidate)
+{
+    int current = __atomic_load_n(value, __ATOMIC_RELAXED);
+    while (candidate < current &&
+           !__atomic_compare_exchange_n(value, &current, candidate, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static void atomicMax(int* value, int candidate)
+{
+    int current = __atomic_load_n(value, __ATOMIC_RELAXED);
+    while (candidate > current &&
+           !__atomic_compare_exchange_n(value, &current, candidate, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+/**
+ * @brief Grow the current frame's drawn rectangle to cover [x0, x1) x [y0, y1)
+ */
+static void markDrawn(RenderContext* context, int x0, int y0, int x1, int y1)
+{
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+    atomicMin(&context->drawnRect.x0, x0);
+    atomicMin(&context->drawnRect.y0, y0);
+    atomicMax(&context->drawnRect.x1, x1);
+    atomicMax(&context->drawnRect.y1, y1);
+}
+
+/**
+ * @brief Forget all tracked rectangles after both buffers were cleared in full
+ */
+static void resetDrawnRects(RenderContext* context)
+{
+    context->drawnRect = emptyRect;
+    context->previousDrawnRect = emptyRect;
+    context->frameStaleRect = emptyRect;
+    context->depthStaleRect = emptyRect;
+    context->depthStorageStale = 1;
+}
+
+/**
+ * @brief Pack a frame epoch and a positive inverse depth into one cell value
+ *
+ * Positive IEEE floats order like their bit patterns, so comparing keys
+ * compares epochs first and inverse depths within an epoch.
+ */
+static inline uint64_t makeDepthKey(uint32_t epoch, float inverseDepth)
+{
+    uint32_t bits;
+    memcpy(&bits, &inverseDepth, sizeof(bits));
+    return (uint64_t)epoch << 32 | bits;
+}
+
+/**
+ * @brief Depth-test a packed cell value against one cell of a packed target
+ */
+static inline void writePackedCell(const RenderTarget* target, unsigned index, uint32_t cell)
+{
+    const uint32_t stored = target->packedCells[index];
+    if (cell >> 16 > stored >> 16 || (cell >> 16 == stored >> 16 && (cell & 0xFFu) < (stored & 0xFFu))) {
+        target->packedCells[index] = cell;
+    }
+}
+
+/**
+ * @brief Depth-test one cell of a resolved target and keep the nearer sample
+ *
+ * At equal depth the smaller glyph wins, so a cell's final glyph does not
+ * depend on the order samples arrive in: tiles, work-stealing threads and
+ * their merge all write in different orders.
+ */
+static inline void writeSample(const RenderTarget* target, unsigned index, float inverseDepth, char glyph)
+{
+    if (target->packedCells != NULL) {
+        /* Depths that round to 0 (or are not positive) would lose against a cleared cell */
+        const float scaled = inverseDepth * target->packedDepthScale;
+        if (scaled >= 1.0f) {
+            const uint32_t depth = scaled < (float)PACKED_DEPTH_MAX ? (uint32_t)scaled : PACKED_DEPTH_MAX;
+            writePackedCell(target, index, depth << 16 | (unsigned char)glyph);
+        }
+    } else if (target->depthKeys != NULL) {
+        /* Non-positive depths would not pass against a cleared float cell either */
+        if (inverseDepth > 0.0f) {
+            const uint64_t key = makeDepthKey(target->depthEpoch, inverseDepth);
+            if (key > target->depthKeys[index] ||
+                (key == target->depthKeys[index] && (unsigned char)glyph < (unsigned char)target->frame[index])) {
+                target->depthKeys[index] = key;
+                target->frame[index] = glyph;
+            }
+        }
+    } else if (inverseDepth > target->depth[index] ||
+               (inverseDepth == target->depth[index] && inverseDepth > 0.0f &&
+                (unsigned char)glyph < (unsigned char)target->frame[index])) {
+        target->depth[index] = inverseDepth;
+        target->frame[index] = glyph;
+    }
+}
 
 /**
  * @brief Validate window dimensions against supported limits
@@ -33,133 +159,315 @@ static int validateDimensions(int width, int height)
             height >= MIN_WINDOW_HEIGHT && height <= MAX_WINDOW_HEIGHT);
 }
 
-int initializeRenderer(int width, int height)
+/**
+ * @brief Round size up to a multiple of alignment (a power of two)
+ */
+static size_t alignUp(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Map the arena block, on huge pages if hugePages asks for them
+ *
+ * Explicit MAP_HUGETLB pages are tried first; they need a reserved huge page
+ * pool, so the fallback is regular pages with madvise(MADV_HUGEPAGE), which
+ * lets transparent huge pages back the block where the kernel allows it.
+ */
+static void* mapArena(size_t bytes, int hugePages, RenderArenaBacking* backing)
+{
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    *backing = RENDER_ARENA_PAGES;
+
+#ifdef MAP_HUGETLB
+    if (hugePages) {
+        void* block = mmap(NULL, bytes, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+        if (block != MAP_FAILED) {
+            *backing = RENDER_ARENA_HUGETLB;
+            return block;
+        }
+    }
+#endif
+
+    void* block = mmap(NULL, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (block == MAP_FAILED) {
+        return NULL;
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (hugePages && madvise(block, bytes, MADV_HUGEPAGE) == 0) {
+        *backing = RENDER_ARENA_TRANSPARENT_HUGE;
+    }
+#endif
+    return block;
+}
+
+int initializeRenderer(RenderContext* context, int width, int height)
 {
     /* Validate input dimensions */
-    if (!validateDimensions(width, height)) {
+    if (context == NULL || !validateDimensions(width, height)) {
         return ALLOCATION_FAILURE;
     }
 
     /* Free existing buffers if allocated */
-    cleanupRenderer();
+    cleanupRenderer(context);
 
-    /* Set new dimensions */
-    windowWidth = width;
-    windowHeight = height;
-    bufferSize = width * height;
+    /* Carve 64-byte aligned sections for the largest window out of one block.
+     * The depth section is sized for the widest layout (epoch keys) and
+     * shared by all of them */
+    const size_t cells = (size_t)MAX_WINDOW_WIDTH * MAX_WINDOW_HEIGHT;
+    const size_t depthOffset = 0;
+    const size_t frameOffset = depthOffset + alignUp(cells * sizeof(uint64_t), RENDER_ARENA_ALIGNMENT);
+    const size_t outputOffset = frameOffset + alignUp(cells, RENDER_ARENA_ALIGNMENT);
+    const size_t previousOffset = outputOffset + alignUp(PRESENT_OUTPUT_CAPACITY, RENDER_ARENA_ALIGNMENT);
+    const size_t coarseOffset = previousOffset + alignUp(cells, RENDER_ARENA_ALIGNMENT);
+    const size_t coarseTiles = (size_t)((MAX_WINDOW_WIDTH + COARSE_DEPTH_TILE - 1) / COARSE_DEPTH_TILE) *
+                               ((MAX_WINDOW_HEIGHT + COARSE_DEPTH_TILE - 1) / COARSE_DEPTH_TILE);
+    const size_t bytes = alignUp(coarseOffset + coarseTiles * sizeof(float),
+                                 context->hugePages ? RENDER_HUGE_PAGE_SIZE : RENDER_ARENA_ALIGNMENT);
 
-    /* Allocate depth buffer */
-    zBuffer = (float*)calloc(bufferSize, sizeof(float));
-    if (zBuffer == NULL) {
+    RenderArenaBacking backing;
+    char* block = (char*)mapArena(bytes, context->hugePages, &backing);
+    if (block == NULL) {
         return ALLOCATION_FAILURE;
     }
 
-    /* Allocate frame buffer */
-    frameBuffer = (char*)malloc(bufferSize * sizeof(char));
-    if (frameBuffer == NULL) {
-        free(zBuffer);
-        zBuffer = NULL;
-        return ALLOCATION_FAILURE;
-    }
+    /* Anonymous mappings are zero-filled, so every depth layout starts cleared */
+    RenderArena* arena = &context->arena;
+    arena->base = block;
+    arena->bytes = bytes;
+    arena->backing = backing;
+    arena->frame = block + frameOffset;
+    arena->output = block + outputOffset;
+    arena->previousFrame = block + previousOffset;
+    context->zBuffer = (float*)(block + depthOffset);
+    context->depthKeys = (uint64_t*)(block + depthOffset);
+    context->packedCells = (uint32_t*)(block + depthOffset);
+    context->coarseDepth = (float*)(block + coarseOffset);
+    context->frameBuffer = arena->frame;
+
+    /* Set new dimensions */
+    context->windowWidth = width;
+    context->windowHeight = height;
+    context->bufferSize = width * height;
 
     /* Initialize frame buffer with background character */
-    memset(frameBuffer, backgroundChar, bufferSize);
+    memset(context->frameBuffer, context->backgroundChar, context->bufferSize);
+    resetDrawnRects(context);
 
     return ALLOCATION_SUCCESS;
 }
 
-void cleanupRenderer(void)
+void cleanupRenderer(RenderContext* context)
 {
-    if (zBuffer != NULL) {
-        free(zBuffer);
-        zBuffer = NULL;
+    if (context == NULL) {
+        return;
     }
-    
-    if (frameBuffer != NULL) {
-        free(frameBuffer);
-        frameBuffer = NULL;
+
+    RenderArena* arena = &context->arena;
+    if (arena->base != NULL) {
+        munmap(arena->base, arena->bytes);
     }
-    
-    bufferSize = 0;
+    arena->base = NULL;
+    arena->bytes = 0;
+    arena->backing = RENDER_ARENA_PAGES;
+    arena->frame = NULL;
+    arena->output = NULL;
+    arena->previousFrame = NULL;
+
+    context->zBuffer = NULL;
+    context->frameBuffer = NULL;
+    context->depthKeys = NULL;
+    context->packedCells = NULL;
+    context->coarseDepth = NULL;
+    context->depthEpoch = 0;
+
+    cleanupWorkStealing(context);
+    context->bufferSize = 0;
+}
+
+RenderArena getRendererArena(const RenderContext* context)
+{
+    return context->arena;
 }
 
-int resizeRenderer(int newWidth, int newHeight)
+int resizeRenderer(RenderContext* context, int newWidth, int newHeight)
 {
     /* Validate new dimensions */
-    if (!validateDimensions(newWidth, newHeight)) {
+    if (context == NULL || !validateDimensions(newWidth, newHeight)) {
+        return ALLOCATION_FAILURE;
+    }
+
+    if (context->zBuffer == NULL || context->frameBuffer == NULL) {
         return ALLOCATION_FAILURE;
     }
 
     /* If dimensions haven't changed, nothing to do */
-    if (newWidth == windowWidth && newHeight == windowHeight) {
+    if (newWidth == context->windowWidth && newHeight == context->windowHeight) {
         return ALLOCATION_SUCCESS;
     }
 
-    /* Store old buffers for cleanup */
-    float* oldZBuffer = zBuffer;
-    char* oldFrameBuffer = frameBuffer;
+    /* The arena already covers every valid size; the next
+     * initializeDepthBuffer() clears the depth cells in full */
+    context->windowWidth = newWidth;
+    context->windowHeight = newHeight;
+    context->bufferSize = newWidth * newHeight;
+    memset(context->frameBuffer, context->backgroundChar, context->bufferSize);
+    resetDrawnRects(context);
 
-    /* Try to allocate new buffers */
-    int newBufferSize = newWidth * newHeight;
-    float* newZBuffer = (float*)calloc(newBufferSize, sizeof(float));
-    char* newFrameBuffer = (char*)malloc(newBufferSize * sizeof(char));
+    return ALLOCATION_SUCCESS;
+}
 
-    if (newZBuffer == NULL || newFrameBuffer == NULL) {
-        /* Allocation failed, cleanup and keep old buffers */
-        free(newZBuffer);
-        free(newFrameBuffer);
+int bindRendererFrameBuffer(RenderContext* context, char* frame)
+{
+    if (context == NULL || context->arena.frame == NULL) {
         return ALLOCATION_FAILURE;
     }
 
-    /* Update global state */
-    windowWidth = newWidth;
-    windowHeight = newHeight;
-    bufferSize = newBufferSize;
-    zBuffer = newZBuffer;
-    frameBuffer = newFrameBuffer;
+    frame = frame != NULL ? frame : context->arena.frame;
+    if (frame == context->frameBuffer) {
+        return ALLOCATION_SUCCESS;
+    }
 
-    /* Initialize new frame buffer */
-    memset(frameBuffer, backgroundChar, bufferSize);
+    /* Nothing is known about the new cells; start over as after a resize */
+    context->frameBuffer = frame;
+    memset(context->frameBuffer, context->backgroundChar, context->bufferSize);
+    resetDrawnRects(context);
+    return ALLOCATION_SUCCESS;
+}
 
-    /* Free old buffers */
-    free(oldZBuffer);
-    free(oldFrameBuffer);
+int initializeFrameBuffer(RenderContext* context)
+{
+    if (context == NULL || context->frameBuffer == NULL || context->bufferSize <= 0) {
+        return ALLOCATION_FAILURE;
+    }
 
+    /* A new frame begins: the last one's cells still need clearing in both buffers */
+    context->frameStaleRect = unionRect(context->frameStaleRect, context->drawnRect);
+    context->depthStaleRect = unionRect(context->depthStaleRect, context->drawnRect);
+    context->previousDrawnRect = context->drawnRect;
+    context->drawnRect = emptyRect;
+
+    const RenderRect stale = publicRect(context->frameStaleRect);
+    for (int row = stale.y0; row < stale.y1; row++) {
+        memset(context->frameBuffer + (size_t)row * context->windowWidth + stale.x0,
+               context->backgroundChar, (size_t)(stale.x1 - stale.x0));
+    }
+    context->frameStaleRect = emptyRect;
     return ALLOCATION_SUCCESS;
 }
 
-int initializeFrameBuffer(void)
+/**
+ * @brief Advance the frame epoch of DEPTH_BUFFER_EPOCH
+ *
+ * @param reset Zero every cell first, as the section may hold another layout
+ */
+static void advanceDepthEpoch(RenderContext* context, int reset)
 {
-    if (frameBuffer == NULL || bufferSize <= 0) {
+    /* Epoch 0 marks cleared cells, so a wrap needs one real clear */
+    if (reset || ++context->depthEpoch == 0) {
+        memset(context->depthKeys, 0, (size_t)context->bufferSize * sizeof(uint64_t));
+        context->depthEpoch = 1;
+    }
+}
+
+/**
+ * @brief Reset packed cells to depth 0 and the background glyph
+ */
+static void clearPackedCells(RenderContext* context, RenderRect stale)
+{
+    /* Inverse depths up to the near limit map onto the full 16-bit range */
+    context->packedDepthScale = (float)PACKED_DEPTH_MAX * (float)context->viewerDistance * PACKED_DEPTH_NEAR_FRACTION;
+
+    const uint32_t cleared = (unsigned char)context->backgroundChar;
+    for (int row = stale.y0; row < stale.y1; row++) {
+        uint32_t* cell = context->packedCells + (size_t)row * context->windowWidth;
+        for (int column = stale.x0; column < stale.x1; column++) {
+            cell[column] = cleared;
+        }
+    }
+}
+
+int initializeDepthBuffer(RenderContext* context)
+{
+    if (context == NULL || context->zBuffer == NULL || context->bufferSize <= 0) {
         return ALLOCATION_FAILURE;
     }
-    
-    memset(frameBuffer, backgroundChar, bufferSize);
+
+    /* Covers a call before initializeFrameBuffer(), which then merely repeats it */
+    context->depthStaleRect = unionRect(context->depthStaleRect, context->drawnRect);
+
+    /* The stale rectangle only describes the storage of the mode that drew it */
+    if (context->depthBufferMode != context->activeDepthMode) {
+        context->activeDepthMode = context->depthBufferMode;
+        context->depthStorageStale = 1;
+    }
+    RenderRect stale = publicRect(context->depthStaleRect);
+    if (context->depthStorageStale) {
+        stale.x0 = 0;
+        stale.y0 = 0;
+        stale.x1 = context->windowWidth;
+        stale.y1 = context->windowHeight;
+    }
+
+    switch (context->activeDepthMode) {
+    case DEPTH_BUFFER_EPOCH:
+        /* Cells of all earlier epochs read as cleared */
+        advanceDepthEpoch(context, context->depthStorageStale);
+        break;
+    case DEPTH_BUFFER_PACKED:
+        clearPackedCells(context, stale);
+        break;
+    default:
+        for (int row = stale.y0; row < stale.y1; row++) {
+            memset(context->zBuffer + (size_t)row * context->windowWidth + stale.x0, 0,
+                   (size_t)(stale.x1 - stale.x0) * sizeof(float));
+        }
+        break;
+    }
+
+    /* Nothing is drawn yet, so nothing is occluded */
+    const int coarseColumns = (context->windowWidth + COARSE_DEPTH_TILE - 1) / COARSE_DEPTH_TILE;
+    const int coarseRows = (context->windowHeight + COARSE_DEPTH_TILE - 1) / COARSE_DEPTH_TILE;
+    memset(context->coarseDepth, 0, (size_t)coarseColumns * (size_t)coarseRows * sizeof(float));
+
+    context->depthStaleRect = emptyRect;
+    context->depthStorageStale = 0;
     return ALLOCATION_SUCCESS;
 }
 
-int initializeDepthBuffer(void)
+int resolveFrameBuffer(RenderContext* context)
 {
-    if (zBuffer == NULL || bufferSize <= 0) {
+    if (context == NULL || context->frameBuffer == NULL || context->bufferSize <= 0) {
         return ALLOCATION_FAILURE;
     }
-    
-    memset(zBuffer, 0, bufferSize * sizeof(float));
+    if (context->activeDepthMode != DEPTH_BUFFER_PACKED) {
+        return ALLOCATION_SUCCESS;
+    }
+
+    /* Outside the drawn rectangle both buffers already hold the background */
+    const RenderRect drawn = publicRect(context->drawnRect);
+    for (int row = drawn.y0; row < drawn.y1; row++) {
+        const uint32_t* cell = context->packedCells + (size_t)row * context->windowWidth;
+        char* glyph = context->frameBuffer + (size_t)row * context->windowWidth;
+        for (int column = drawn.x0; column < drawn.x1; column++) {
+            glyph[column] = (char)(cell[column] & 0xFFu);
+        }
+    }
     return ALLOCATION_SUCCESS;
 }
 
-void calculateForSurface(Point3D cubePoint, int ch, Rotation3D rotation)
+void calculateForSurface(RenderContext* context, Point3D cubePoint, int ch, const Transform3D* transform)
 {
     /* Verify buffers are allocated */
-    if (frameBuffer == NULL || zBuffer == NULL || bufferSize <= 0) {
+    if (context == NULL || context->frameBuffer == NULL || context->zBuffer == NULL ||
+        context->bufferSize <= 0 || transform == NULL) {
         return; /* Buffers not properly initialized */
     }
 
-    /* Apply 3D rotation transformations */
-    Point3D projected;
-    projected.x = calculateX(cubePoint, rotation);
-    projected.y = calculateY(cubePoint, rotation);
-    projected.z = calculateZ(cubePoint, rotation) + viewerDistance;
+    /* Apply precomputed 3D rotation transform */
+    Point3D projected = transformPoint(transform, cubePoint);
+    projected.z += context->viewerDistance;
 
     /* Guard against division by zero or negative depth */
     if (projected.z <= 0.0f) {
@@ -167,9 +475,10 @@ void calculateForSurface(Point3D cubePoint, int ch, Rotation3D rotation)
     }
 
     /* Calculate perspective projection */
+    const int windowWidth = context->windowWidth, windowHeight = context->windowHeight;
     float inverseDepth = 1.0f / projected.z;
-    int screenX = (int)(windowWidth / 2 + projectionScaleFactor * inverseDepth * projected.x * 2);
-    int screenY = (int)(windowHeight / 2 + projectionScaleFactor * inverseDepth * projected.y);
+    int screenX = (int)(windowWidth / 2 + context->projectionScaleFactor * inverseDepth * projected.x * 2);
+    int screenY = (int)(windowHeight / 2 + context->projectionScaleFactor * inverseDepth * projected.y);
 
     /* Comprehensive bounds checking for screen coordinates */
     if (screenX < 0 || screenX >= windowWidth || screenY < 0 || screenY >= windowHeight) {
@@ -177,21 +486,610 @@ void calculateForSurface(Point3D cubePoint, int ch, Rotation3D rotation)
     }
 
     /* Calculate buffer index with comprehensive bounds verification */
-    bufferIndex = screenX + screenY * windowWidth;
+    const int bufferIndex = screenX + screenY * windowWidth;
     
     /* Double-check buffer index bounds */
-    if (bufferIndex < 0 || bufferIndex >= bufferSize) {
+    if (bufferIndex < 0 || bufferIndex >= context->bufferSize) {
         return; /* Buffer index out of bounds */
     }
 
-    /* Verify buffer validity before access */
-    if (frameBuffer == NULL || zBuffer == NULL) {
-        return; /* Buffers became invalid */
+    /* Z-buffer test for visibility with bounds-safe access */
+    const RenderTarget target = getRendererTarget(context);
+    writeSample(&target, (unsigned)bufferIndex, inverseDepth, (char)ch);
+    markDrawn(context, screenX, screenY, screenX + 1, screenY + 1);
+}
+
+Projection3D getRendererProjection(const RenderContext* context)
+{
+    Projection3D projection;
+    projection.viewerDistance = (float)context->viewerDistance;
+    projection.scaleX = context->projectionScaleFactor * 2.0f;
+    projection.scaleY = context->projectionScaleFactor;
+    projection.centerX = (float)(context->windowWidth / 2);
+    projection.centerY = (float)(context->windowHeight / 2);
+    return projection;
+}
+
+RenderTarget getRendererTarget(const RenderContext* context)
+{
+    RenderTarget target;
+    target.depth = context->zBuffer;
+    target.frame = context->frameBuffer;
+    target.width = context->windowWidth;
+    target.height = context->windowHeight;
+    target.clip.x0 = 0;
+    target.clip.y0 = 0;
+    target.clip.x1 = context->windowWidth;
+    target.clip.y1 = context->windowHeight;
+    /* A newly selected mode takes over once initializeDepthBuffer() has cleared its cells */
+    target.depthKeys = context->activeDepthMode == DEPTH_BUFFER_EPOCH ? context->depthKeys : NULL;
+    target.depthEpoch = context->depthEpoch;
+    target.packedCells = context->activeDepthMode == DEPTH_BUFFER_PACKED ? context->packedCells : NULL;
+    target.packedDepthScale = context->packedDepthScale;
+    return target;
+}
+
+void mergeRenderTarget(RenderContext* context, const RenderTarget* source, int begin, int end)
+{
+    if (context == NULL || source == NULL || context->frameBuffer == NULL || context->zBuffer == NULL) {
+        return;
     }
 
-    /* Z-buffer test for visibility with bounds-safe access */
-    if (inverseDepth > zBuffer[bufferIndex]) {
-        zBuffer[bufferIndex] = inverseDepth;
-        frameBuffer[bufferIndex] = (char)ch;
+    const RenderTarget target = getRendererTarget(context);
+    if (source->packedCells != NULL ? target.packedCells == NULL : source->depth == NULL || source->frame == NULL) {
+        return;
     }
-}
\ No newline at end of file
+
+    begin = begin > 0 ? begin : 0;
+    end = end < context->bufferSize ? end : context->bufferSize;
+
+    /* Only cells a source actually wrote (depth above 0) can change the frame */
+    const int width = context->windowWidth;
+    int firstRow = INT_MAX, lastRow = INT_MIN, firstColumn = INT_MAX, lastColumn = INT_MIN;
+    for (int index = begin; index < end; index++) {
+        int written;
+        if (source->packedCells != NULL) {
+            written = source->packedCells[index] != 0;
+            if (written) {
+                writePackedCell(&target, (unsigned)index, source->packedCells[index]);
+            }
+        } else {
+            written = source->depth[index] > 0.0f;
+            if (written) {
+                writeSample(&target, (unsigned)index, source->depth[index], source->frame[index]);
+            }
+        }
+        if (written) {
+            const int row = index / width, column = index % width;
+            firstRow = row < firstRow ? row : firstRow;
+            lastRow = row;
+            firstColumn = column < firstColumn ? column : firstColumn;
+            lastColumn = column > lastColumn ? column : lastColumn;
+        }
+    }
+    markDrawn(context, firstColumn, firstRow, lastColumn + 1, lastRow + 1);
+}
+
+RenderRect getRendererDrawnRect(const RenderContext* context)
+{
+    return publicRect(context->drawnRect);
+}
+
+RenderRect getRendererDirtyRect(const RenderContext* context)
+{
+    return publicRect(unionRect(context->previousDrawnRect, context->drawnRect));
+}
+
+/**
+ * @brief Inverse depth a cell of the active depth layout holds, 0 if cleared
+ *
+ * Packed cells truncate on write, so depth / packedDepthScale is at most the
+ * inverse depth that stored them: anything at or behind it fails the test.
+ */
+static inline float readCellDepth(const RenderContext* context, size_t index)
+{
+    switch (context->activeDepthMode) {
+    case DEPTH_BUFFER_EPOCH: {
+        const uint64_t key = context->depthKeys[index];
+        if ((uint32_t)(key >> 32) != context->depthEpoch) {
+            return 0.0f;
+        }
+        const uint32_t bits = (uint32_t)key;
+        float inverseDepth;
+        memcpy(&inverseDepth, &bits, sizeof(inverseDepth));
+        return inverseDepth;
+    }
+    case DEPTH_BUFFER_PACKED:
+        return (float)(context->packedCells[index] >> 16) / context->packedDepthScale;
+    default:
+        return context->zBuffer[index];
+    }
+}
+
+/**
+ * @brief Clamp a rectangle to the window and widen it to whole coarse tiles
+ *
+ * @return Non-zero if any tile remains
+ */
+static int coarseTileRange(const RenderContext* context, RenderRect rect, RenderRect* tiles)
+{
+    const int x0 = rect.x0 > 0 ? rect.x0 : 0;
+    const int y0 = rect.y0 > 0 ? rect.y0 : 0;
+    const int x1 = rect.x1 < context->windowWidth ? rect.x1 : context->windowWidth;
+    const int y1 = rect.y1 < context->windowHeight ? rect.y1 : context->windowHeight;
+    if (x0 >= x1 || y0 >= y1) {
+        return 0;
+    }
+    tiles->x0 = x0 / COARSE_DEPTH_TILE;
+    tiles->y0 = y0 / COARSE_DEPTH_TILE;
+    tiles->x1 = (x1 - 1) / COARSE_DEPTH_TILE + 1;
+    tiles->y1 = (y1 - 1) / COARSE_DEPTH_TILE + 1;
+    return 1;
+}
+
+void updateCoarseDepth(RenderContext* context, RenderRect rect)
+{
+    RenderRect tiles;
+    if (context == NULL || context->coarseDepth == NULL || !coarseTileRange(context, rect, &tiles)) {
+        return;
+    }
+
+    const int width = context->windowWidth, height = context->windowHeight;
+    const int columns = (width + COARSE_DEPTH_TILE - 1) / COARSE_DEPTH_TILE;
+    for (int tileY = tiles.y0; tileY < tiles.y1; tileY++) {
+        const int rowEnd = (tileY + 1) * COARSE_DEPTH_TILE < height ? (tileY + 1) * COARSE_DEPTH_TILE : height;
+        for (int tileX = tiles.x0; tileX < tiles.x1; tileX++) {
+            const int columnEnd = (tileX + 1) * COARSE_DEPTH_TILE < width ? (tileX + 1) * COARSE_DEPTH_TILE : width;
+            float farthest = INFINITY;
+            for (int row = tileY * COARSE_DEPTH_TILE; row < rowEnd && farthest > 0.0f; row++) {
+                for (int column = tileX * COARSE_DEPTH_TILE; column < columnEnd; column++) {
+                    const float depth = readCellDepth(context, (size_t)row * width + column);
+                    farthest = depth < farthest ? depth : farthest;
+                }
+            }
+            context->coarseDepth[tileY * columns + tileX] = farthest;
+        }
+    }
+}
+
+int isRectOccluded(const RenderContext* context, RenderRect rect, float nearestInverseDepth)
+{
+    RenderRect tiles;
+    if (context == NULL || context->coarseDepth == NULL) {
+        return 0;
+    }
+    if (!coarseTileRange(context, rect, &tiles)) {
+        return 1;
+    }
+
+    const int columns = (context->windowWidth + COARSE_DEPTH_TILE - 1) / COARSE_DEPTH_TILE;
+    for (int tileY = tiles.y0; tileY < tiles.y1; tileY++) {
+        for (int tileX = tiles.x0; tileX < tiles.x1; tileX++) {
+            if (!(nearestInverseDepth <= context->coarseDepth[tileY * columns + tileX])) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Shared state of one tiled frame, read by all pool threads
+ */
+typedef struct
+{
+    RenderContext* context;
+    RenderTileFunction function;
+    void* data;
+    int tileColumns;
+    int tileCount;
+    int nextTile;       /* Claimed with atomic fetch-add */
+} TiledFrame;
+
+/**
+ * @brief Pool task: claim tiles until none are left
+ */
+static void renderTilesTask(void* context, int threadIndex, int threadCount)
+{
+    TiledFrame* frame = (TiledFrame*)context;
+    (void)threadIndex;
+    (void)threadCount;
+
+    for (;;) {
+        const int tile = __atomic_fetch_add(&frame->nextTile, 1, __ATOMIC_RELAXED);
+        if (tile >= frame->tileCount) {
+            break;
+        }
+
+        RenderTarget target = getRendererTarget(frame->context);
+        target.clip.x0 = (tile % frame->tileColumns) * RENDER_TILE_WIDTH;
+        target.clip.y0 = (tile / frame->tileColumns) * RENDER_TILE_HEIGHT;
+        target.clip.x1 = target.clip.x0 + RENDER_TILE_WIDTH < target.width ? target.clip.x0 + RENDER_TILE_WIDTH : target.width;
+        target.clip.y1 = target.clip.y0 + RENDER_TILE_HEIGHT < target.height ? target.clip.y0 + RENDER_TILE_HEIGHT : target.height;
+        frame->function(frame->data, &target);
+    }
+}
+
+void renderTiled(RenderContext* context, RenderTileFunction function, void* data)
+{
+    if (context == NULL || function == NULL) {
+        return;
+    }
+
+    if (getThreadPoolSize() <= 1) {
+        const RenderTarget target = getRendererTarget(context);
+        function(data, &target);
+        return;
+    }
+
+    TiledFrame frame;
+    frame.context = context;
+    frame.function = function;
+    frame.data = data;
+    frame.tileColumns = (context->windowWidth + RENDER_TILE_WIDTH - 1) / RENDER_TILE_WIDTH;
+    frame.tileCount = frame.tileColumns * ((context->windowHeight + RENDER_TILE_HEIGHT - 1) / RENDER_TILE_HEIGHT);
+    frame.nextTile = 0;
+
+    runThreadPool(renderTilesTask, &frame);
+}
+
+/**
+ * @brief Resolve an optional target and clamp its clip rectangle to its buffers
+ *
+ * @return 1 if the resolved target has buffers and a non-empty clip, 0 otherwise
+ */
+static int resolveTarget(const RenderContext* context, const RenderTarget* target, RenderTarget* resolved)
+{
+    *resolved = target != NULL ? *target : getRendererTarget(context);
+    if (resolved->depth == NULL || resolved->frame == NULL ||
+        resolved->width <= 0 || resolved->height <= 0) {
+        return 0;
+    }
+
+    resolved->clip.x0 = resolved->clip.x0 > 0 ? resolved->clip.x0 : 0;
+    resolved->clip.y0 = resolved->clip.y0 > 0 ? resolved->clip.y0 : 0;
+    resolved->clip.x1 = resolved->clip.x1 < resolved->width ? resolved->clip.x1 : resolved->width;
+    resolved->clip.y1 = resolved->clip.y1 < resolved->height ? resolved->clip.y1 : resolved->height;
+    return 1;
+}
+
+/**
+ * @brief Shared implementation of the batched submission paths
+ *
+ * @param batch The points and glyphs to render
+ * @param transform Rotation to apply, or NULL when the points are already rotated
+ * @param target Buffers and clip region to write, or NULL for the context's buffers
+ */
+static int renderBatch(RenderContext* context, const SurfaceBatch* batch, const Transform3D* transform,
+                       const RenderTarget* target)
+{
+    /* Validate renderer state and batch once for all points */
+    RenderTarget resolved;
+    if (context == NULL || !resolveTarget(context, target, &resolved)) {
+        return ALLOCATION_FAILURE;
+    }
+    if (batch == NULL || batch->count < 0 ||
+        (batch->count > 0 && (batch->x == NULL || batch->y == NULL || batch->z == NULL))) {
+        return ALLOCATION_FAILURE;
+    }
+
+    /* Local copies let the compiler keep renderer state in registers */
+    const Projection3D projection = getRendererProjection(context);
+    const RenderRect region = resolved.clip;
+    if (region.x0 >= region.x1 || region.y0 >= region.y1) {
+        return ALLOCATION_SUCCESS; /* Nothing of the buffer is writable */
+    }
+    const int left = region.x0, top = region.y0;
+    const unsigned regionWidth = (unsigned)(region.x1 - region.x0);
+    const unsigned regionHeight = (unsigned)(region.y1 - region.y0);
+    const unsigned width = (unsigned)resolved.width;
+    const char* const glyphs = batch->glyphs;
+    const char glyph = (char)batch->glyph;
+
+    int screenX[RENDER_BATCH_SIZE];
+    int screenY[RENDER_BATCH_SIZE];
+    float inverseDepth[RENDER_BATCH_SIZE];
+    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+
+    for (int start = 0; start < batch->count; start += RENDER_BATCH_SIZE) {
+        const int count = batch->count - start < RENDER_BATCH_SIZE ? batch->count - start : RENDER_BATCH_SIZE;
+
+        if (transform != NULL) {
+            transformProjectBatch(transform, &projection,
+                                  batch->x + start, batch->y + start, batch->z + start, count,
+                                  screenX, screenY, inverseDepth);
+        } else {
+            projectBatch(&projection,
+                         batch->x + start, batch->y + start, batch->z + start, count,
+                         screenX, screenY, inverseDepth);
+        }
+
+        /* Unsigned compares reject coordinates on either side in one test */
+        for (int i = 0; i < count; i++) {
+            if ((unsigned)(screenX[i] - left) >= regionWidth || (unsigned)(screenY[i] - top) >= regionHeight) {
+                continue;
+            }
+
+            const unsigned index = (unsigned)screenX[i] + (unsigned)screenY[i] * width;
+            writeSample(&resolved, index, inverseDepth[i], glyphs != NULL ? glyphs[start + i] : glyph);
+            minX = screenX[i] < minX ? screenX[i] : minX;
+            maxX = screenX[i] > maxX ? screenX[i] : maxX;
+            minY = screenY[i] < minY ? screenY[i] : minY;
+            maxY = screenY[i] > maxY ? screenY[i] : maxY;
+        }
+    }
+
+    if (resolved.frame == context->frameBuffer) {
+        markDrawn(context, minX, minY, maxX + 1, maxY + 1);
+    }
+    return ALLOCATION_SUCCESS;
+}
+
+int renderSurfaceBatch(RenderContext* context, const SurfaceBatch* batch, const Transform3D* transform,
+                       const RenderTarget* target)
+{
+    if (transform == NULL) {
+        return ALLOCATION_FAILURE;
+    }
+    return renderBatch(context, batch, transform, target);
+}
+
+int renderRotatedBatch(RenderContext* context, const SurfaceBatch* batch, const RenderTarget* target)
+{
+    return renderBatch(context, batch, NULL, target);
+}
+
+int projectVertex(const RenderContext* context, const Transform3D* transform, Point3D point, ScreenVertex* vertex)
+{
+    const Projection3D projection = getRendererProjection(context);
+    const Point3D rotated = transformPoint(transform, point);
+    const float depth = rotated.z + projection.viewerDistance;
+
+    if (!(depth > 0.0f)) {
+        vertex->x = -1.0f;
+        vertex->y = -1.0f;
+        vertex->inverseDepth = 0.0f;
+        return 0;
+    }
+
+    vertex->inverseDepth = 1.0f / depth;
+    vertex->x = projection.centerX + projection.scaleX * vertex->inverseDepth * rotated.x;
+    vertex->y = projection.centerY + projection.scaleY * vertex->inverseDepth * rotated.y;
+    return 1;
+}
+
+/**
+ * @brief Twice the signed screen-space area of triangle (a, b, c)
+ */
+static float signedArea2(const ScreenVertex* a, const ScreenVertex* b, const ScreenVertex* c)
+{
+    return (b->x - a->x) * (c->y - a->y) - (c->x - a->x) * (b->y - a->y);
+}
+
+/**
+ * @brief Scan-convert a convex polygon of a planar primitive into a resolved target
+ *
+ * Fills every cell of the clip rectangle whose center lies inside the
+ * polygon with the inverse depth of the plane through anchor.
+ *
+ * @param resolved Target with its clip rectangle clamped to its buffers
+ * @param polygon Projected vertices in perimeter order (either winding)
+ * @param count Number of vertices (3 or 4)
+ * @param anchor Vertex the depth plane is evaluated relative to
+ * @param depthStepX Change of inverse depth per column
+ * @param depthStepY Change of inverse depth per row
+ * @param glyph Character written by cells that pass the depth test
+ * @param drawn Grown to cover every cell visited
+ */
+static void scanConvexPolygon(const RenderTarget* resolved, const ScreenVertex* polygon, int count,
+                              const ScreenVertex* anchor, float depthStepX, float depthStepY, char glyph,
+                              RenderRect* drawn)
+{
+    /* Vertical extent in rows whose centers fall inside the polygon */
+    float minY = polygon[0].y, maxY = polygon[0].y;
+    for (int i = 1; i < count; i++) {
+        minY = fminf(minY, polygon[i].y);
+        maxY = fmaxf(maxY, polygon[i].y);
+    }
+    /* Clamp in float space first so off-screen vertices cannot overflow the casts */
+    const RenderRect region = resolved->clip;
+    const int firstRow = (int)ceilf(fminf(fmaxf(minY - 0.5f, (float)region.y0), (float)region.y1));
+    const int lastRow = (int)ceilf(fminf(fmaxf(maxY - 0.5f, (float)region.y0), (float)region.y1)) - 1;
+
+    const int width = resolved->width;
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        const float centerY = (float)row + 0.5f;
+        float spanLeft = INFINITY, spanRight = -INFINITY;
+
+        /* Intersect the row center line with every edge of the convex polygon */
+        for (int i = 0; i < count; i++) {
+            const ScreenVertex* from = &polygon[i];
+            const ScreenVertex* to = &polygon[i + 1 < count ? i + 1 : 0];
+            if ((from->y <= centerY && centerY < to->y) || (to->y <= centerY && centerY < from->y)) {
+                const float crossX = from->x + (centerY - from->y) * (to->x - from->x) / (to->y - from->y);
+                spanLeft = fminf(spanLeft, crossX);
+                spanRight = fmaxf(spanRight, crossX);
+            }
+        }
+        if (!(spanLeft < spanRight)) {
+            continue;
+        }
+
+        const int firstColumn = (int)ceilf(fminf(fmaxf(spanLeft - 0.5f, (float)region.x0), (float)region.x1));
+        const int lastColumn = (int)ceilf(fminf(fmaxf(spanRight - 0.5f, (float)region.x0), (float)region.x1)) - 1;
+
+        /* Evaluate the plane per cell rather than accumulating, so a cell's
+         * depth does not depend on where the clip rectangle starts the span */
+        const float rowDepth = anchor->inverseDepth + depthStepY * (centerY - anchor->y);
+        int index = row * width + firstColumn;
+
+        for (int column = firstColumn; column <= lastColumn; column++, index++) {
+            const float inverseDepth = rowDepth + depthStepX * ((float)column + 0.5f - anchor->x);
+            writeSample(resolved, (unsigned)index, inverseDepth, glyph);
+        }
+
+        if (firstColumn <= lastColumn) {
+            drawn->x0 = firstColumn < drawn->x0 ? firstColumn : drawn->x0;
+            drawn->x1 = lastColumn + 1 > drawn->x1 ? lastColumn + 1 : drawn->x1;
+            drawn->y0 = row < drawn->y0 ? row : drawn->y0;
+            drawn->y1 = row + 1 > drawn->y1 ? row + 1 : drawn->y1;
+        }
+    }
+}
+
+/**
+ * @brief Inverse-depth plane gradients of triangle (a, b, c) with twice its signed area
+ */
+static void planeDepthSteps(const ScreenVertex* a, const ScreenVertex* b, const ScreenVertex* c, float area,
+                            float* depthStepX, float* depthStepY)
+{
+    *depthStepX = ((b->inverseDepth - a->inverseDepth) * (c->y - a->y) -
+                   (c->inverseDepth - a->inverseDepth) * (b->y - a->y)) / area;
+    *depthStepY = ((b->x - a->x) * (c->inverseDepth - a->inverseDepth) -
+                   (c->x - a->x) * (b->inverseDepth - a->inverseDepth)) / area;
+}
+
+int rasterizeQuad(RenderContext* context, const ScreenVertex quad[4], int ch, const RenderTarget* target)
+{
+    RenderTarget resolved;
+    if (context == NULL || !resolveTarget(context, target, &resolved)) {
+        return ALLOCATION_FAILURE;
+    }
+
+    /* Without near-plane clipping, partially visible quads are dropped */
+    for (int i = 0; i < 4; i++) {
+        if (!(quad[i].inverseDepth > 0.0f)) {
+            return ALLOCATION_SUCCESS;
+        }
+    }
+
+    /* Derive the inverse-depth plane from the better-conditioned half of the quad */
+    const ScreenVertex* a = &quad[0];
+    const ScreenVertex* b = &quad[1];
+    const ScreenVertex* c = &quad[2];
+    float area = signedArea2(&quad[0], &quad[1], &quad[2]);
+    const float otherArea = signedArea2(&quad[0], &quad[2], &quad[3]);
+    if (fabsf(otherArea) > fabsf(area)) {
+        b = &quad[2];
+        c = &quad[3];
+        area = otherArea;
+    }
+    if (fabsf(area) < 1e-6f) {
+        return ALLOCATION_SUCCESS; /* Edge-on face covers no cell centers */
+    }
+
+    float depthStepX, depthStepY;
+    planeDepthSteps(a, b, c, area, &depthStepX, &depthStepY);
+
+    RenderRect drawn = emptyRect;
+    scanConvexPolygon(&resolved, quad, 4, a, depthStepX, depthStepY, (char)ch, &drawn);
+
+    if (resolved.frame == context->frameBuffer) {
+        markDrawn(context, drawn.x0, drawn.y0, drawn.x1, drawn.y1);
+    }
+    return ALLOCATION_SUCCESS;
+}
+
+/**
+ * @brief ceilf() for values in [0, INT_MAX] without the library call
+ */
+static inline int ceilNonNegative(float value)
+{
+    const int truncated = (int)value;
+    return truncated + ((float)truncated < value);
+}
+
+/**
+ * @brief Screen-space bounding box of a projected triangle
+ *
+ * Plain compares rather than fminf()/fmaxf(), which are library calls
+ * without -ffast-math and would dominate the cost of sub-cell triangles.
+ */
+static inline void triangleBounds(const ScreenVertex vertices[3], float* minX, float* maxX, float* minY, float* maxY)
+{
+    *minX = *maxX = vertices[0].x;
+    *minY = *maxY = vertices[0].y;
+    for (int i = 1; i < 3; i++) {
+        *minX = vertices[i].x < *minX ? vertices[i].x : *minX;
+        *maxX = vertices[i].x > *maxX ? vertices[i].x : *maxX;
+        *minY = vertices[i].y < *minY ? vertices[i].y : *minY;
+        *maxY = vertices[i].y > *maxY ? vertices[i].y : *maxY;
+    }
+}
+
+int rasterizeTriangles(RenderContext* context, const TriangleBatch* batch, const RenderTarget* target)
+{
+    /* Validate renderer state and batch once for all triangles */
+    RenderTarget resolved;
+    if (context == NULL || !resolveTarget(context, target, &resolved)) {
+        return ALLOCATION_FAILURE;
+    }
+    if (batch == NULL || batch->count < 0 ||
+        (batch->count > 0 && (batch->x == NULL || batch->y == NULL ||
+                              batch->inverseDepth == NULL || batch->indices == NULL))) {
+        return ALLOCATION_FAILURE;
+    }
+
+    const RenderRect region = resolved.clip;
+    if (region.x0 >= region.x1 || region.y0 >= region.y1) {
+        return ALLOCATION_SUCCESS; /* Nothing of the buffer is writable */
+    }
+
+    /* Cell centers of the clip rectangle, for rejecting triangles that cover none */
+    const float clipLeft = (float)region.x0 + 0.5f, clipRight = (float)region.x1 - 0.5f;
+    const float clipTop = (float)region.y0 + 0.5f, clipBottom = (float)region.y1 - 0.5f;
+    const char* const glyphs = batch->glyphs;
+    const char glyph = (char)batch->glyph;
+    RenderRect drawn = emptyRect;
+
+    for (int i = 0; i < batch->count; i++) {
+        const int triangle = batch->order != NULL ? batch->order[i] : i;
+        const int* indices = batch->indices + 3 * (size_t)triangle;
+        ScreenVertex vertices[3];
+        for (int corner = 0; corner < 3; corner++) {
+            vertices[corner].x = batch->x[indices[corner]];
+            vertices[corner].y = batch->y[indices[corner]];
+            vertices[corner].inverseDepth = batch->inverseDepth[indices[corner]];
+        }
+
+        /* Without near-plane clipping, partially visible triangles are dropped */
+        if (!(vertices[0].inverseDepth > 0.0f && vertices[1].inverseDepth > 0.0f &&
+              vertices[2].inverseDepth > 0.0f)) {
+            continue;
+        }
+
+        /* Most triangles of a dense mesh miss the tile entirely */
+        float minX, maxX, minY, maxY;
+        triangleBounds(vertices, &minX, &maxX, &minY, &maxY);
+        if (maxX < clipLeft || minX > clipRight || maxY < clipTop || minY > clipBottom) {
+            continue;
+        }
+        /* ...or are smaller than a cell and fall between cell centers
+         * (ceil(v - 0.5) = ceil(v + 0.5) - 1, kept non-negative by the clamp) */
+        const float left = minX > (float)region.x0 ? minX : (float)region.x0;
+        const float right = maxX < (float)region.x1 ? maxX : (float)region.x1;
+        const float top = minY > (float)region.y0 ? minY : (float)region.y0;
+        const float bottom = maxY < (float)region.y1 ? maxY : (float)region.y1;
+        if (ceilNonNegative(left + 0.5f) >= ceilNonNegative(right + 0.5f) ||
+            ceilNonNegative(top + 0.5f) >= ceilNonNegative(bottom + 0.5f)) {
+            continue;
+        }
+
+        /* Screen rows grow downward, so a counter-clockwise (front) face has negative area */
+        const float area = signedArea2(&vertices[0], &vertices[1], &vertices[2]);
+        if (fabsf(area) < 1e-6f || (batch->cullBackFaces && area > 0.0f)) {
+            continue;
+        }
+
+        float depthStepX, depthStepY;
+        planeDepthSteps(&vertices[0], &vertices[1], &vertices[2], area, &depthStepX, &depthStepY);
+        scanConvexPolygon(&resolved, vertices, 3, &vertices[0], depthStepX, depthStepY,
+                          glyphs != NULL ? glyphs[triangle] : glyph, &drawn);
+    }
+
+    if (resolved.frame == context->frameBuffer) {
+        markDrawn(context, drawn.x0, drawn.y0, drawn.x1, drawn.y1);
+    }
+    return ALLOCATION_SUCCESS;
+}
@@ -0,0 +1,641 @@
+/**
+ * @file scene.c
+ * @author D. Heger
+ * @brief Instanced scenes, their spatial grid and frustum culling
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "scene.h"
+#include "context.h"
+#include "threadpool.h"
+
+/** Frustum planes: left, right, top, bottom and near */
+#define SCENE_FRUSTUM_PLANES 5
+
+/** Bounding sphere padding covering rounding in projected and interpolated depths */
+#define SCENE_BOUND_PADDING 1.001f
+
+/**
+ * @brief Round size up to a multiple of alignment (a power of two)
+ */
+static size_t alignUp(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+int initializeScene(Scene* scene, const Mesh* mesh)
+{
+    if (scene == NULL || mesh == NULL || mesh->block == NULL) {
+        return ALLOCATION_FAILURE;
+    }
+    memset(scene, 0, sizeof(*scene));
+    scene->mesh = mesh;
+    scene->occlusionCulling = 1;
+
+    /* Instances are culled as spheres around their position */
+    float radiusSquared = 0.0f;
+    for (int vertex = 0; vertex < mesh->vertexCount; vertex++) {
+        const float lengthSquared = mesh->x[vertex] * mesh->x[vertex] + mesh->y[vertex] * mesh->y[vertex] +
+                                    mesh->z[vertex] * mesh->z[vertex];
+        radiusSquared = fmaxf(radiusSquared, lengthSquared);
+    }
+    scene->meshRadius = sqrtf(radiusSquared);
+    return ALLOCATION_SUCCESS;
+}
+
+int addSceneInstance(Scene* scene, SceneInstance instance)
+{
+    if (scene == NULL || scene->instanceCount >= SCENE_MAX_INSTANCES ||
+        !isfinite(instance.position.x) || !isfinite(instance.position.y) || !isfinite(instance.position.z) ||
+        !(instance.scale > 0.0f) || !isfinite(instance.scale)) {
+        return ALLOCATION_FAILURE;
+    }
+
+    if (scene->instanceCount == scene->instanceCapacity) {
+        const int capacity = scene->instanceCapacity > 0 ? 2 * scene->instanceCapacity : 64;
+        SceneInstance* grown = (SceneInstance*)realloc(scene->instances, (size_t)capacity * sizeof(SceneInstance));
+        if (grown == NULL) {
+            return ALLOCATION_FAILURE;
+        }
+        scene->instances = grown;
+        scene->instanceCapacity = capacity;
+    }
+
+    scene->instances[scene->instanceCount++] = instance;
+    scene->indexStale = 1;
+    return ALLOCATION_SUCCESS;
+}
+
+int layoutSceneGrid(Scene* scene, int count, int layers, float spacing, float scale)
+{
+    if (scene == NULL || count < 0 || layers < 1) {
+        return ALLOCATION_FAILURE;
+    }
+
+    const int perLayer = (count + layers - 1) / layers;
+    int columns = 1;
+    while ((long)columns * columns < perLayer) {
+        columns++;
+    }
+    const int rows = perLayer > 0 ? (perLayer + columns - 1) / columns : 0;
+
+    for (int i = 0; i < count; i++) {
+        const int cell = i % perLayer;
+        SceneInstance instance;
+        instance.position.x = ((float)(cell % columns) - 0.5f * (float)(columns - 1)) * spacing;
+        instance.position.y = ((float)(cell / columns) - 0.5f * (float)(rows - 1)) * spacing;
+        instance.position.z = (float)(i / perLayer) * spacing;
+        /* Irrational-ish steps keep neighbours out of phase */
+        instance.rotation.x = 0.37f * (float)i;
+        instance.rotation.y = 0.61f * (float)i;
+        instance.rotation.z = 0.0f;
+        instance.scale = scale;
+        if (addSceneInstance(scene, instance) != ALLOCATION_SUCCESS) {
+            return ALLOCATION_FAILURE;
+        }
+    }
+    return ALLOCATION_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Spatial index                                                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Grid cell of a position
+ */
+static int findSceneCell(const Scene* scene, float x, float y)
+{
+    int column = (int)((x - scene->gridOriginX) * scene->gridCellsPerUnitX);
+    int row = (int)((y - scene->gridOriginY) * scene->gridCellsPerUnitY);
+    column = column < scene->gridColumns ? column : scene->gridColumns - 1;
+    row = row < scene->gridRows ? row : scene->gridRows - 1;
+    return row * scene->gridColumns + column;
+}
+
+/**
+ * @brief Pick a grid of about SCENE_GRID_CELL_INSTANCES instances per cell
+ *        whose cells are roughly square over the instances' extent
+ */
+static void sizeSceneGrid(Scene* scene, float extentX, float extentY)
+{
+    const int cells = (scene->instanceCount + SCENE_GRID_CELL_INSTANCES - 1) / SCENE_GRID_CELL_INSTANCES;
+    int columns = 1, rows = 1;
+    if (extentX > 0.0f && extentY > 0.0f) {
+        columns = (int)ceilf(sqrtf((float)cells * extentX / extentY));
+        columns = columns < 1 ? 1 : columns > SCENE_GRID_MAX_CELLS ? SCENE_GRID_MAX_CELLS : columns;
+        rows = (cells + columns - 1) / columns;
+    } else if (extentX > 0.0f) {
+        columns = cells;
+    } else if (extentY > 0.0f) {
+        rows = cells;
+    }
+
+    scene->gridColumns = columns < SCENE_GRID_MAX_CELLS ? columns : SCENE_GRID_MAX_CELLS;
+    scene->gridRows = rows < 1 ? 1 : rows < SCENE_GRID_MAX_CELLS ? rows : SCENE_GRID_MAX_CELLS;
+    scene->gridCellsPerUnitX = extentX > 0.0f ? (float)scene->gridColumns / extentX : 0.0f;
+    scene->gridCellsPerUnitY = extentY > 0.0f ? (float)scene->gridRows / extentY : 0.0f;
+}
+
+int updateSceneIndex(Scene* scene)
+{
+    if (scene == NULL) {
+        return ALLOCATION_FAILURE;
+    }
+
+    free(scene->indexBlock);
+    scene->indexBlock = NULL;
+    scene->cellStart = NULL;
+    scene->cellInstances = NULL;
+    scene->cellBounds = NULL;
+    scene->drawQueue = NULL;
+    scene->gridColumns = 0;
+    scene->gridRows = 0;
+    scene->indexStale = 0;
+    if (scene->instanceCount == 0) {
+        return ALLOCATION_SUCCESS;
+    }
+
+    float minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY;
+    for (int i = 0; i < scene->instanceCount; i++) {
+        minX = fminf(minX, scene->instances[i].position.x);
+        maxX = fmaxf(maxX, scene->instances[i].position.x);
+        minY = fminf(minY, scene->instances[i].position.y);
+        maxY = fmaxf(maxY, scene->instances[i].position.y);
+    }
+    scene->gridOriginX = minX;
+    scene->gridOriginY = minY;
+    sizeSceneGrid(scene, maxX - minX, maxY - minY);
+    const int cellCount = scene->gridColumns * scene->gridRows;
+
+    const size_t startBytes = alignUp((size_t)(cellCount + 1) * sizeof(int), RENDER_ARENA_ALIGNMENT);
+    const size_t listBytes = alignUp((size_t)scene->instanceCount * sizeof(int), RENDER_ARENA_ALIGNMENT);
+    const size_t queueBytes = alignUp((size_t)scene->instanceCount * sizeof(SceneDrawItem), RENDER_ARENA_ALIGNMENT);
+    const size_t boundsBytes = alignUp((size_t)cellCount * 6 * sizeof(float), RENDER_ARENA_ALIGNMENT);
+    void* block = NULL;
+    if (posix_memalign(&block, RENDER_ARENA_ALIGNMENT, startBytes + listBytes + queueBytes + boundsBytes) != 0) {
+        scene->indexStale = 1;
+        return ALLOCATION_FAILURE;
+    }
+    char* cursor = (char*)block;
+    scene->cellStart = (int*)cursor;        cursor += startBytes;
+    scene->cellInstances = (int*)cursor;    cursor += listBytes;
+    scene->drawQueue = (SceneDrawItem*)cursor; cursor += queueBytes;
+    scene->cellBounds = (float*)cursor;
+    scene->indexBlock = block;
+
+    /* Counting sort by cell; the bounds grow by every instance's sphere */
+    int* start = scene->cellStart;
+    memset(start, 0, (size_t)(cellCount + 1) * sizeof(int));
+    for (int cell = 0; cell < cellCount; cell++) {
+        float* bounds = scene->cellBounds + 6 * (size_t)cell;
+        bounds[0] = bounds[1] = bounds[2] = INFINITY;
+        bounds[3] = bounds[4] = bounds[5] = -INFINITY;
+    }
+    for (int i = 0; i < scene->instanceCount; i++) {
+        const SceneInstance* instance = &scene->instances[i];
+        const int cell = findSceneCell(scene, instance->position.x, instance->position.y);
+        const float radius = scene->meshRadius * instance->scale;
+        const float center[3] = {instance->position.x, instance->position.y, instance->position.z};
+        float* bounds = scene->cellBounds + 6 * (size_t)cell;
+        for (int axis = 0; axis < 3; axis++) {
+            bounds[axis] = fminf(bounds[axis], center[axis] - radius);
+            bounds[axis + 3] = fmaxf(bounds[axis + 3], center[axis] + radius);
+        }
+        start[cell + 1]++;
+    }
+    for (int cell = 0; cell < cellCount; cell++) {
+        start[cell + 1] += start[cell];
+    }
+    for (int i = 0; i < scene->instanceCount; i++) {
+        const int cell = findSceneCell(scene, scene->instances[i].position.x, scene->instances[i].position.y);
+        scene->cellInstances[start[cell]++] = i;
+    }
+    memmove(start + 1, start, (size_t)cellCount * sizeof(int));
+    start[0] = 0;
+    return ALLOCATION_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Culling                                                                    */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Per-frame scene state shared by the pool threads and render tiles
+ */
+typedef struct
+{
+    RenderContext* context;     /**< Context rendered into */
+    Scene* scene;               /**< Scene drawn; receives the projected vertices */
+    Projection3D projection;    /**< Projection of the context */
+    Rotation3D spin;            /**< Rotation added to every instance's */
+    int batchCount;             /**< Instances in the current batch */
+} SceneFrame;
+
+/**
+ * @brief Build the planes bounding what a context's window shows
+ *
+ * Each plane is (nx, ny, nz, w) with a unit normal pointing into the
+ * frustum, so n . p + w is the signed distance of p from it. The side
+ * planes pass through the viewer at z = -viewerDistance and the window
+ * edges; the near plane through the viewer.
+ */
+static void buildFrustumPlanes(const RenderContext* context, const Projection3D* projection,
+                               float planes[SCENE_FRUSTUM_PLANES][4])
+{
+    /* Window edges as slopes x / (z + viewerDistance) and y / (z + viewerDistance) */
+    const float left = -projection->centerX / projection->scaleX;
+    const float right = ((float)context->windowWidth - projection->centerX) / projection->scaleX;
+    const float top = -projection->centerY / projection->scaleY;
+    const float bottom = ((float)context->windowHeight - projection->centerY) / projection->scaleY;
+    const float distance = projection->viewerDistance;
+
+    const float raw[SCENE_FRUSTUM_PLANES][3] = {
+        {1.0f, 0.0f, -left},
+        {-1.0f, 0.0f, right},
+        {0.0f, 1.0f, -top},
+        {0.0f, -1.0f, bottom},
+        {0.0f, 0.0f, 1.0f},
+    };
+    for (int plane = 0; plane < SCENE_FRUSTUM_PLANES; plane++) {
+        const float length = sqrtf(raw[plane][0] * raw[plane][0] + raw[plane][1] * raw[plane][1] +
+                                   raw[plane][2] * raw[plane][2]);
+        planes[plane][0] = raw[plane][0] / length;
+        planes[plane][1] = raw[plane][1] / length;
+        planes[plane][2] = raw[plane][2] / length;
+        planes[plane][3] = raw[plane][2] * distance / length;
+    }
+}
+
+/** Box classification against the frustum */
+typedef enum
+{
+    SCENE_BOX_OUTSIDE = 0,  /**< Entirely outside one plane */
+    SCENE_BOX_STRADDLES,    /**< Crosses at least one plane */
+    SCENE_BOX_INSIDE        /**< Inside every plane */
+} SceneBoxClass;
+
+/**
+ * @brief Classify an axis-aligned box (min and max corner) against the frustum
+ */
+static SceneBoxClass classifyBox(const float planes[SCENE_FRUSTUM_PLANES][4], const float bounds[6])
+{
+    const float center[3] = {0.5f * (bounds[0] + bounds[3]), 0.5f * (bounds[1] + bounds[4]),
+                             0.5f * (bounds[2] + bounds[5])};
+    const float half[3] = {0.5f * (bounds[3] - bounds[0]), 0.5f * (bounds[4] - bounds[1]),
+                           0.5f * (bounds[5] - bounds[2])};
+
+    SceneBoxClass result = SCENE_BOX_INSIDE;
+    for (int plane = 0; plane < SCENE_FRUSTUM_PLANES; plane++) {
+        const float* p = planes[plane];
+        const float distance = p[0] * center[0] + p[1] * center[1] + p[2] * center[2] + p[3];
+        const float reach = fabsf(p[0]) * half[0] + fabsf(p[1]) * half[1] + fabsf(p[2]) * half[2];
+        if (distance + reach < 0.0f) {
+            return SCENE_BOX_OUTSIDE;
+        }
+        if (distance - reach < 0.0f) {
+            result = SCENE_BOX_STRADDLES;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Test an instance's bounding sphere against the frustum
+ */
+static int sphereInFrustum(const float planes[SCENE_FRUSTUM_PLANES][4], Point3D center, float radius)
+{
+    for (int plane = 0; plane < SCENE_FRUSTUM_PLANES; plane++) {
+        const float* p = planes[plane];
+        if (p[0] * center.x + p[1] * center.y + p[2] * center.z + p[3] < -radius) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Bound where an instance can land on screen and how near it comes
+ *
+ * Works from the bounding sphere alone, before any vertex is transformed.
+ */
+static void boundSceneInstance(const SceneFrame* frame, int index, SceneDrawItem* item)
+{
+    const SceneInstance* instance = &frame->scene->instances[index];
+    const Projection3D* projection = &frame->projection;
+    const int width = frame->context->windowWidth, height = frame->context->windowHeight;
+    const float radius = frame->scene->meshRadius * instance->scale * SCENE_BOUND_PADDING;
+    const float nearDepth = instance->position.z + projection->viewerDistance - radius;
+
+    item->instance = index;
+    if (!(nearDepth > 0.0f)) {
+        /* Reaches the viewer, so it may cover anything and nothing hides it */
+        item->nearestDepth = INFINITY;
+        item->bounds = (RenderRect){0, 0, width, height};
+        return;
+    }
+    item->nearestDepth = 1.0f / nearDepth;
+
+    /* For a fixed x, x / depth is monotonic in depth, so the sphere's box
+     * projects inside the extremes of its near and far faces */
+    const float farDepth = nearDepth + 2.0f * radius;
+    const float left = instance->position.x - radius, right = instance->position.x + radius;
+    const float top = instance->position.y - radius, bottom = instance->position.y + radius;
+    const float minX = projection->centerX + projection->scaleX * fminf(left / nearDepth, left / farDepth);
+    const float maxX = projection->centerX + projection->scaleX * fmaxf(right / nearDepth, right / farDepth);
+    const float minY = projection->centerY + projection->scaleY * fminf(top / nearDepth, top / farDepth);
+    const float maxY = projection->centerY + projection->scaleY * fmaxf(bottom / nearDepth, bottom / farDepth);
+
+    item->bounds.x0 = minX > 1.0f ? (int)(minX - 1.0f) : 0;
+    item->bounds.y0 = minY > 1.0f ? (int)(minY - 1.0f) : 0;
+    item->bounds.x1 = maxX < (float)(width - 1) ? (int)maxX + 2 : width;
+    item->bounds.y1 = maxY < (float)(height - 1) ? (int)maxY + 2 : height;
+}
+
+/**
+ * @brief Order draw items nearest first, ties by instance index
+ */
+static int compareDrawItems(const void* lhs, const void* rhs)
+{
+    const SceneDrawItem* a = (const SceneDrawItem*)lhs;
+    const SceneDrawItem* b = (const SceneDrawItem*)rhs;
+    if (a->nearestDepth != b->nearestDepth) {
+        return a->nearestDepth > b->nearestDepth ? -1 : 1;
+    }
+    return (a->instance > b->instance) - (a->instance < b->instance);
+}
+
+/**
+ * @brief Queue the instances that may be visible in scene->drawQueue, nearest first
+ *
+ * @return Number of queued instances
+ */
+static int cullScene(const SceneFrame* frame, const float planes[SCENE_FRUSTUM_PLANES][4])
+{
+    Scene* scene = frame->scene;
+    SceneStats* stats = &scene->stats;
+    const int cellCount = scene->gridColumns * scene->gridRows;
+    int visibleCount = 0;
+
+    for (int cell = 0; cell < cellCount; cell++) {
+        const int begin = scene->cellStart[cell], end = scene->cellStart[cell + 1];
+        if (begin == end) {
+            continue;
+        }
+
+        stats->cellsTested++;
+        const SceneBoxClass cellClass = classifyBox(planes, scene->cellBounds + 6 * (size_t)cell);
+        if (cellClass == SCENE_BOX_OUTSIDE) {
+            stats->cellsCulled++;
+            stats->instancesCulled += end - begin;
+            continue;
+        }
+
+        for (int entry = begin; entry < end; entry++) {
+            const int index = scene->cellInstances[entry];
+            if (cellClass == SCENE_BOX_STRADDLES) {
+                const SceneInstance* instance = &scene->instances[index];
+                stats->instancesTested++;
+                if (!sphereInFrustum(planes, instance->position, scene->meshRadius * instance->scale)) {
+                    stats->instancesCulled++;
+                    continue;
+                }
+            }
+            boundSceneInstance(frame, index, &scene->drawQueue[visibleCount++]);
+        }
+    }
+
+    /* Front to back, so nearer instances fill the coarse depth tiles before
+     * the ones they hide are tested */
+    qsort(scene->drawQueue, (size_t)visibleCount, sizeof(SceneDrawItem), compareDrawItems);
+    return visibleCount;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Rendering                                                                  */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Make room in the scratch for a batch of batchCount instances
+ *
+ * @return ALLOCATION_SUCCESS on success, ALLOCATION_FAILURE on error
+ */
+static int reserveSceneScratch(Scene* scene, int batchCount)
+{
+    if (batchCount <= scene->scratchCapacity) {
+        return ALLOCATION_SUCCESS;
+    }
+
+    const int capacity = batchCount > 2 * scene->scratchCapacity ? batchCount : 2 * scene->scratchCapacity;
+    const Mesh* mesh = scene->mesh;
+    const size_t vertexBytes = alignUp((size_t)capacity * (size_t)mesh->vertexCount * sizeof(float),
+                                       RENDER_ARENA_ALIGNMENT);
+    const size_t shadingBytes = mesh->glyphs == NULL ?
+        alignUp((size_t)capacity * (size_t)mesh->triangleCount, RENDER_ARENA_ALIGNMENT) : 0;
+    const size_t rectBytes = alignUp((size_t)capacity * sizeof(RenderRect), RENDER_ARENA_ALIGNMENT);
+    const size_t slotBytes = alignUp((size_t)capacity * sizeof(int), RENDER_ARENA_ALIGNMENT);
+
+    void* block = NULL;
+    if (posix_memalign(&block, RENDER_ARENA_ALIGNMENT, 3 * vertexBytes + shadingBytes + rectBytes + slotBytes) != 0) {
+        return ALLOCATION_FAILURE;
+    }
+    free(scene->scratchBlock);
+
+    char* cursor = (char*)block;
+    scene->screenX = (float*)cursor;        cursor += vertexBytes;
+    scene->screenY = (float*)cursor;        cursor += vertexBytes;
+    scene->inverseDepth = (float*)cursor;   cursor += vertexBytes;
+    scene->screenRects = (RenderRect*)cursor; cursor += rectBytes;
+    scene->batchInstances = (int*)cursor;   cursor += slotBytes;
+    scene->shading = shadingBytes > 0 ? cursor : NULL;
+    scene->scratchCapacity = capacity;
+    scene->scratchBlock = block;
+    return ALLOCATION_SUCCESS;
+}
+
+/**
+ * @brief Transform and project the instances in batch slots [begin, end)
+ *
+ * Also records the cells each instance can reach, so tiles skip the
+ * instances that miss them without looking at their triangles.
+ */
+static void transformSceneRange(const SceneFrame* frame, int begin, int end)
+{
+    Scene* scene = frame->scene;
+    const Mesh* mesh = scene->mesh;
+    const int width = frame->context->windowWidth, height = frame->context->windowHeight;
+
+    for (int slot = begin; slot < end; slot++) {
+        const SceneInstance* instance = &scene->instances[scene->batchInstances[slot]];
+        const Rotation3D rotation = {instance->rotation.x + frame->spin.x, instance->rotation.y + frame->spin.y,
+                                     instance->rotation.z + frame->spin.z};
+        const Transform3D transform = buildRotationTransform(rotation);
+
+        const size_t vertexBase = (size_t)slot * (size_t)mesh->vertexCount;
+        float* x = scene->screenX + vertexBase;
+        float* y = scene->screenY + vertexBase;
+        float* inverseDepth = scene->inverseDepth + vertexBase;
+        projectMeshVertices(mesh, &transform, instance->scale, instance->position, &frame->projection,
+                            0, mesh->vertexCount, x, y, inverseDepth);
+        if (scene->shading != NULL) {
+            shadeMeshTriangles(mesh, &transform, 0, mesh->triangleCount,
+                               scene->shading + (size_t)slot * (size_t)mesh->triangleCount);
+        }
+
+        /* Triangles touching a vertex behind the viewer are skipped, so the
+         * vertices in front bound everything drawn; a cell of slack on each
+         * side keeps this conservative without rounding exactly */
+        float minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY;
+        for (int vertex = 0; vertex < mesh->vertexCount; vertex++) {
+            if (inverseDepth[vertex] > 0.0f) {
+                minX = x[vertex] < minX ? x[vertex] : minX;
+                maxX = x[vertex] > maxX ? x[vertex] : maxX;
+                minY = y[vertex] < minY ? y[vertex] : minY;
+                maxY = y[vertex] > maxY ? y[vertex] : maxY;
+            }
+        }
+        RenderRect* rect = &scene->screenRects[slot];
+        if (!(maxX >= 0.0f && minX <= (float)width && maxY >= 0.0f && minY <= (float)height)) {
+            rect->x0 = rect->y0 = rect->x1 = rect->y1 = 0;
+            continue;
+        }
+        rect->x0 = minX > 1.0f ? (int)(minX - 1.0f) : 0;
+        rect->y0 = minY > 1.0f ? (int)(minY - 1.0f) : 0;
+        rect->x1 = maxX < (float)(width - 1) ? (int)maxX + 2 : width;
+        rect->y1 = maxY < (float)(height - 1) ? (int)maxY + 2 : height;
+    }
+}
+
+/**
+ * @brief Pool task: transform an equal share of the batch
+ */
+static void transformSceneTask(void* data, int threadIndex, int threadCount)
+{
+    const SceneFrame* frame = (const SceneFrame*)data;
+    const long count = frame->batchCount;
+    transformSceneRange(frame, (int)(count * threadIndex / threadCount),
+                        (int)(count * (threadIndex + 1) / threadCount));
+}
+
+/**
+ * @brief Rasterize the instances of the batch overlapping one render tile
+ */
+static void drawSceneRegion(void* data, const RenderTarget* target)
+{
+    const SceneFrame* frame = (const SceneFrame*)data;
+    const Scene* scene = frame->scene;
+    const Mesh* mesh = scene->mesh;
+
+    TriangleBatch batch;
+    batch.indices = mesh->indices;
+    batch.glyph = frame->context->backgroundChar;
+    batch.order = NULL;
+    batch.count = mesh->triangleCount;
+    batch.cullBackFaces = mesh->backFaceCulling;
+
+    for (int slot = 0; slot < frame->batchCount; slot++) {
+        const RenderRect* rect = &scene->screenRects[slot];
+        if (rect->x1 <= target->clip.x0 || rect->x0 >= target->clip.x1 ||
+            rect->y1 <= target->clip.y0 || rect->y0 >= target->clip.y1) {
+            continue;
+        }
+
+        const size_t vertexBase = (size_t)slot * (size_t)mesh->vertexCount;
+        batch.x = scene->screenX + vertexBase;
+        batch.y = scene->screenY + vertexBase;
+        batch.inverseDepth = scene->inverseDepth + vertexBase;
+        batch.glyphs = scene->shading != NULL ? scene->shading + (size_t)slot * (size_t)mesh->triangleCount
+                                              : mesh->glyphs;
+        rasterizeTriangles(frame->context, &batch, target);
+    }
+}
+
+/**
+ * @brief Transform and rasterize the current batch, then refresh the coarse
+ *        depth tiles under it for the batches behind
+ */
+static void drawSceneBatch(SceneFrame* frame)
+{
+    Scene* scene = frame->scene;
+    scene->stats.instancesDrawn += frame->batchCount;
+    if (getThreadPoolSize() > 1) {
+        runThreadPool(transformSceneTask, frame);
+    } else {
+        transformSceneRange(frame, 0, frame->batchCount);
+    }
+    renderTiled(frame->context, drawSceneRegion, frame);
+
+    if (scene->occlusionCulling) {
+        RenderRect drawn = {INT_MAX, INT_MAX, INT_MIN, INT_MIN};
+        for (int slot = 0; slot < frame->batchCount; slot++) {
+            const RenderRect* rect = &scene->screenRects[slot];
+            if (rect->x0 >= rect->x1) {
+                continue;
+            }
+            drawn.x0 = rect->x0 < drawn.x0 ? rect->x0 : drawn.x0;
+            drawn.y0 = rect->y0 < drawn.y0 ? rect->y0 : drawn.y0;
+            drawn.x1 = rect->x1 > drawn.x1 ? rect->x1 : drawn.x1;
+            drawn.y1 = rect->y1 > drawn.y1 ? rect->y1 : drawn.y1;
+        }
+        updateCoarseDepth(frame->context, drawn);
+    }
+}
+
+void drawScene(RenderContext* context, Scene* scene, Rotation3D spin)
+{
+    if (context == NULL || scene == NULL || scene->mesh == NULL) {
+        return;
+    }
+    memset(&scene->stats, 0, sizeof(scene->stats));
+    if ((!scene->indexStale || updateSceneIndex(scene) == ALLOCATION_SUCCESS) && scene->instanceCount > 0) {
+        SceneFrame frame;
+        frame.context = context;
+        frame.scene = scene;
+        frame.projection = getRendererProjection(context);
+        frame.spin = spin;
+
+        /* Whole grid cells go first, so instances far outside the window cost nothing */
+        float planes[SCENE_FRUSTUM_PLANES][4];
+        buildFrustumPlanes(context, &frame.projection, planes);
+        const int visibleCount = cullScene(&frame, planes);
+
+        /* A fixed batch bounds the scratch by the mesh size, not the visible instance count */
+        const int batchSize = SCENE_BATCH_INSTANCES;
+        if (visibleCount > 0 && reserveSceneScratch(scene, batchSize) == ALLOCATION_SUCCESS) {
+            frame.batchCount = 0;
+            for (int entry = 0; entry < visibleCount; entry++) {
+                const SceneDrawItem* item = &scene->drawQueue[entry];
+                if (scene->occlusionCulling && isRectOccluded(context, item->bounds, item->nearestDepth)) {
+                    scene->stats.instancesOccluded++;
+                    continue;
+                }
+                scene->batchInstances[frame.batchCount++] = item->instance;
+                if (frame.batchCount == batchSize) {
+                    drawSceneBatch(&frame);
+                    frame.batchCount = 0;
+                }
+            }
+            if (frame.batchCount > 0) {
+                drawSceneBatch(&frame);
+            }
+        }
+    }
+    resolveFrameBuffer(context);
+}
+
+void destroyScene(Scene* scene)
+{
+    if (scene == NULL) {
+        return;
+    }
+    free(scene->instances);
+    free(scene->indexBlock);
+    free(scene->scratchBlock);
+    memset(scene, 0, sizeof(*scene));
+}
@@ -0,0 +1,186 @@
+/**
+ * @file threadpool.c
+ * @author D. Heger
+ * @brief Persistent worker thread pool implementation
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "threadpool.h"
+
+/**
+ * @brief One runThreadPool() call, queued until every thread index is claimed
+ *
+ * Lives on the caller's stack, so runs from different threads never share
+ * task state. Fields below task are guarded by poolMutex.
+ */
+typedef struct PoolJob
+{
+    ThreadPoolTask task;
+    void* context;
+    int threadCount;            /* Indices the task runs with */
+    int nextIndex;              /* Next index to hand out */
+    int unfinished;             /* Indices not run to completion yet */
+    struct PoolJob* next;       /* Next job in the queue */
+} PoolJob;
+
+/* Pool state, guarded by poolMutex */
+static pthread_t* workerThreads = NULL;
+static int workerCount = 0;             /* Threads excluding the caller */
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t workAvailable = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t workFinished = PTHREAD_COND_INITIALIZER;
+static PoolJob* jobQueue = NULL;        /* Jobs with unclaimed indices, oldest first */
+static int shuttingDown = 0;
+
+/**
+ * @brief Claim the next index of a queued job, unqueueing it once all are claimed
+ *
+ * Must be called with poolMutex held and job->nextIndex < job->threadCount.
+ */
+static int claimJobIndex(PoolJob* job)
+{
+    const int index = job->nextIndex++;
+    if (job->nextIndex == job->threadCount) {
+        PoolJob** link = &jobQueue;
+        while (*link != job) {
+            link = &(*link)->next;
+        }
+        *link = job->next;
+    }
+    return index;
+}
+
+/**
+ * @brief Worker main loop: claim an index of the oldest job, run it, report back
+ */
+static void* workerMain(void* argument)
+{
+    (void)argument;
+
+    pthread_mutex_lock(&poolMutex);
+    for (;;) {
+        while (!shuttingDown && jobQueue == NULL) {
+            pthread_cond_wait(&workAvailable, &poolMutex);
+        }
+        if (shuttingDown) {
+            break;
+        }
+
+        PoolJob* job = jobQueue;
+        const int threadIndex = claimJobIndex(job);
+        pthread_mutex_unlock(&poolMutex);
+
+        job->task(job->context, threadIndex, job->threadCount);
+
+        pthread_mutex_lock(&poolMutex);
+        if (--job->unfinished == 0) {
+            pthread_cond_broadcast(&workFinished);
+        }
+    }
+    pthread_mutex_unlock(&poolMutex);
+
+    return NULL;
+}
+
+int initializeThreadPool(int threadCount)
+{
+    cleanupThreadPool();
+
+    if (threadCount == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threadCount = online > 0 ? (int)online : 1;
+    }
+    if (threadCount < 1 || threadCount > MAX_RENDER_THREADS) {
+        return ALLOCATION_FAILURE;
+    }
+    if (threadCount == 1) {
+        return ALLOCATION_SUCCESS; /* Caller renders alone, no workers needed */
+    }
+
+    workerThreads = (pthread_t*)malloc((size_t)(threadCount - 1) * sizeof(pthread_t));
+    if (workerThreads == NULL) {
+        return ALLOCATION_FAILURE;
+    }
+
+    for (int i = 0; i < threadCount - 1; i++) {
+        if (pthread_create(&workerThreads[i], NULL, workerMain, NULL) != 0) {
+            cleanupThreadPool(); /* Joins the workers started so far */
+            return ALLOCATION_FAILURE;
+        }
+        pthread_mutex_lock(&poolMutex);
+        workerCount = i + 1;
+        pthread_mutex_unlock(&poolMutex);
+    }
+
+    return ALLOCATION_SUCCESS;
+}
+
+void cleanupThreadPool(void)
+{
+    if (workerThreads == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&poolMutex);
+    shuttingDown = 1;
+    pthread_cond_broadcast(&workAvailable);
+    pthread_mutex_unlock(&poolMutex);
+
+    for (int i = 0; i < workerCount; i++) {
+        pthread_join(workerThreads[i], NULL);
+    }
+
+    free(workerThreads);
+    workerThreads = NULL;
+    workerCount = 0;
+    shuttingDown = 0;
+}
+
+int getThreadPoolSize(void)
+{
+    return workerCount + 1;
+}
+
+void runThreadPool(ThreadPoolTask task, void* context)
+{
+    if (task == NULL) {
+        return;
+    }
+    if (workerCount == 0) {
+        task(context, 0, 1);
+        return;
+    }
+
+    /* Runs from different threads queue up and share the workers */
+    PoolJob job = {task, context, workerCount + 1, 1, workerCount + 1, NULL};
+    pthread_mutex_lock(&poolMutex);
+    PoolJob** link = &jobQueue;
+    while (*link != NULL) {
+        link = &(*link)->next;
+    }
+    *link = &job;
+    pthread_cond_broadcast(&workAvailable);
+    pthread_mutex_unlock(&poolMutex);
+
+    /* The caller works as thread 0 instead of idling */
+    task(context, 0, job.threadCount);
+
+    /* Indices no worker has claimed yet, e.g. while they serve other runs, are run here */
+    pthread_mutex_lock(&poolMutex);
+    job.unfinished--;
+    while (job.nextIndex < job.threadCount) {
+        const int threadIndex = claimJobIndex(&job);
+        pthread_mutex_unlock(&poolMutex);
+        task(context, threadIndex, job.threadCount);
+        pthread_mutex_lock(&poolMutex);
+        job.unfinished--;
+    }
+    while (job.unfinished > 0) {
+        pthread_cond_wait(&workFinished, &poolMutex);
+    }
+    pthread_mutex_unlock(&poolMutex);
+}
@@ -0,0 +1,247 @@
+/**
+ * @file worksteal.c
+ * @author D. Heger
+ * @brief Work-stealing scheduler implementation
+ * @version 1.3.0
+ * @date 2026-10-16
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "worksteal.h"
+#include "context.h"
+#include "threadpool.h"
+
+/**
+ * @brief One thread's deque of item indices
+ *
+ * Items are dealt as a contiguous range as the frame starts and never pushed
+ * afterwards, so the deque is just [head, tail) packed into one word. The
+ * owner pops the head and thieves take the tail, both with a single CAS.
+ * Each deque sits on its own cache line.
+ */
+typedef struct
+{
+    uint64_t range;     /**< head << 32 | tail */
+} __attribute__((aligned(64))) StealDeque;
+
+/**
+ * @brief Per-frame state shared by all threads
+ *
+ * Lives on the caller's stack for one renderWorkStealing() call, so contexts
+ * rendering from different threads never share deques. The private buffers
+ * of threads 1..n-1 live in the context; thread 0 renders into its buffers.
+ */
+typedef struct
+{
+    StealDeque deques[MAX_RENDER_THREADS];  /**< One per pool thread, all dealt before the run */
+    RenderContext* context;
+    RenderItemFunction function;
+    void* data;
+    int steals;         /* Accumulated with atomic add */
+} StealFrame;
+
+static uint64_t packRange(uint32_t head, uint32_t tail)
+{
+    return (uint64_t)head << 32 | tail;
+}
+
+/**
+ * @brief Owner side: take the item at the front of a deque
+ *
+ * @return 1 if an item was taken, 0 if the deque is empty
+ */
+static int popFront(StealDeque* deque, int* item)
+{
+    uint64_t range = __atomic_load_n(&deque->range, __ATOMIC_RELAXED);
+    for (;;) {
+        const uint32_t head = (uint32_t)(range >> 32), tail = (uint32_t)range;
+        if (head >= tail) {
+            return 0;
+        }
+        if (__atomic_compare_exchange_n(&deque->range, &range, packRange(head + 1, tail), 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            *item = (int)head;
+            return 1;
+        }
+    }
+}
+
+/**
+ * @brief Thief side: take the item at the back of a deque
+ *
+ * @return 1 if an item was taken, 0 if the deque is empty
+ */
+static int stealBack(StealDeque* deque, int* item)
+{
+    uint64_t range = __atomic_load_n(&deque->range, __ATOMIC_RELAXED);
+    for (;;) {
+        const uint32_t head = (uint32_t)(range >> 32), tail = (uint32_t)range;
+        if (head >= tail) {
+            return 0;
+        }
+        if (__atomic_compare_exchange_n(&deque->range, &range, packRange(head, tail - 1), 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            *item = (int)(tail - 1);
+            return 1;
+        }
+    }
+}
+
+/**
+ * @brief Grow a context's private buffers to hold cells for every extra thread
+ *
+ * Their size depends on the pool, so they stay outside the renderer arena,
+ * but start on the same RENDER_ARENA_ALIGNMENT boundaries.
+ */
+static int reserveThreadBuffers(RenderContext* context, size_t cells)
+{
+    if (cells <= context->threadBufferCapacity) {
+        return ALLOCATION_SUCCESS;
+    }
+
+    void* depth;
+    void* frame;
+    if (posix_memalign(&depth, RENDER_ARENA_ALIGNMENT, cells * sizeof(float)) != 0) {
+        return ALLOCATION_FAILURE;
+    }
+    if (posix_memalign(&frame, RENDER_ARENA_ALIGNMENT, cells * sizeof(char)) != 0) {
+        free(depth);
+        return ALLOCATION_FAILURE;
+    }
+
+    free(context->threadDepth);
+    free(context->threadFrame);
+    context->threadDepth = (float*)depth;
+    context->threadFrame = (char*)frame;
+    context->threadBufferCapacity = cells;
+    return ALLOCATION_SUCCESS;
+}
+
+/**
+ * @brief Pool task: drain the own deque, then steal from the others
+ */
+static void stealItemsTask(void* context, int threadIndex, int threadCount)
+{
+    StealFrame* frame = (StealFrame*)context;
+    const RenderContext* render = frame->context;
+    RenderTarget target = getRendererTarget(render);
+
+    if (threadIndex > 0) {
+        const size_t offset = (size_t)(threadIndex - 1) * (size_t)render->bufferSize;
+        target.depth = render->threadDepth + offset;
+        target.frame = render->threadFrame + offset;
+        target.depthKeys = NULL;
+        memset(target.depth, 0, (size_t)render->bufferSize * sizeof(float));
+        if (target.packedCells != NULL) {
+            /* Quantize like the context's cells so equal-depth ties resolve the same way */
+            target.packedCells = (uint32_t*)target.depth;
+        }
+    }
+
+    int item;
+    while (popFront(&frame->deques[threadIndex], &item)) {
+        frame->function(frame->data, item, &target);
+    }
+
+    /* Deques only shrink, so one pass over the victims leaves nothing behind */
+    int stolen = 0;
+    for (int offset = 1; offset < threadCount; offset++) {
+        StealDeque* victim = &frame->deques[(threadIndex + offset) % threadCount];
+        while (stealBack(victim, &item)) {
+            frame->function(frame->data, item, &target);
+            stolen++;
+        }
+    }
+
+    if (stolen > 0) {
+        __atomic_fetch_add(&frame->steals, stolen, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Pool task: merge the private buffers into one stripe of rows
+ *
+ * Keeps the nearest sample per cell (largest inverse depth, then smallest
+ * glyph). Private cells nobody wrote hold depth 0 and never win.
+ */
+static void mergeBuffersTask(void* context, int threadIndex, int threadCount)
+{
+    RenderContext* render = (RenderContext*)context;
+    const int windowWidth = render->windowWidth, windowHeight = render->windowHeight;
+    const size_t bufferSize = (size_t)render->bufferSize;
+
+    const int begin = windowHeight * threadIndex / threadCount * windowWidth;
+    const int end = windowHeight * (threadIndex + 1) / threadCount * windowWidth;
+
+    RenderTarget source = getRendererTarget(render);
+    const int packed = source.packedCells != NULL;
+    source.depthKeys = NULL;
+    for (int thread = 0; thread < threadCount - 1; thread++) {
+        source.depth = render->threadDepth + (size_t)thread * bufferSize;
+        source.frame = render->threadFrame + (size_t)thread * bufferSize;
+        source.packedCells = packed ? (uint32_t*)source.depth : NULL;
+        mergeRenderTarget(render, &source, begin, end);
+    }
+}
+
+int renderWorkStealing(RenderContext* context, int itemCount, RenderItemFunction function, void* data)
+{
+    if (context == NULL || function == NULL || itemCount < 0 ||
+        context->frameBuffer == NULL || context->zBuffer == NULL || context->bufferSize <= 0) {
+        return ALLOCATION_FAILURE;
+    }
+
+    context->stealStats.items = itemCount;
+    context->stealStats.steals = 0;
+
+    const int threadCount = getThreadPoolSize();
+    if (threadCount <= 1) {
+        const RenderTarget target = getRendererTarget(context);
+        for (int item = 0; item < itemCount; item++) {
+            function(data, item, &target);
+        }
+        return ALLOCATION_SUCCESS;
+    }
+
+    if (reserveThreadBuffers(context, (size_t)(threadCount - 1) * (size_t)context->bufferSize) != ALLOCATION_SUCCESS) {
+        return ALLOCATION_FAILURE;
+    }
+
+    /* Deal contiguous ranges so neighbouring items start on the same thread;
+     * runThreadPool() publishes them to the workers */
+    StealFrame frame;
+    for (int thread = 0; thread < threadCount; thread++) {
+        const uint32_t head = (uint32_t)((long)itemCount * thread / threadCount);
+        const uint32_t tail = (uint32_t)((long)itemCount * (thread + 1) / threadCount);
+        frame.deques[thread].range = packRange(head, tail);
+    }
+    frame.context = context;
+    frame.function = function;
+    frame.data = data;
+    frame.steals = 0;
+    runThreadPool(stealItemsTask, &frame);
+    context->stealStats.steals = frame.steals;
+
+    runThreadPool(mergeBuffersTask, context);
+    return ALLOCATION_SUCCESS;
+}
+
+WorkStealStats getWorkStealStats(const RenderContext* context)
+{
+    return context->stealStats;
+}
+
+void cleanupWorkStealing(RenderContext* context)
+{
+    if (context == NULL) {
+        return;
+    }
+
+    free(context->threadDepth);
+    free(context->threadFrame);
+    context->threadDepth = NULL;
+    context->threadFrame = NULL;
+    context->threadBufferCapacity = 0;
+}
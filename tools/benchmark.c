@@ -30,9 +30,17 @@
 #endif
 #endif
 
+#include "config.h"
 #include "constants.h"
+#include "context.h"
 #include "cube.h"
+#include "math3d.h"
+#include "mesh.h"
+#include "scene.h"
+#include "pacing.h"
 #include "renderer.h"
+#include "threadpool.h"
+#include "worksteal.h"
 
 #define DEFAULT_RUN_SECONDS 10.0
 #define MIN_RUN_SECONDS 1.0
@@ -42,6 +50,11 @@
 #define LOG_DEFAULT_PATH "logs/benchmark.csv"
 #define ENV_RUN_SECONDS "RUN_SECONDS"
 #define ENV_LOG_PATH "CUBE_BENCHMARK_LOG"
+#define ENV_TRANSFORM_KERNEL "CUBE_TRANSFORM_KERNEL"
+#define ENV_RENDER_MODE "CUBE_RENDER_MODE"
+#define ENV_TRAVERSAL "CUBE_TRAVERSAL"
+#define ENV_PARALLEL "CUBE_PARALLEL"
+#define ENV_DEPTH_BUFFER "CUBE_DEPTH_BUFFER"
 
 typedef struct DurationSeries {
     double* values;
@@ -53,6 +66,12 @@ typedef struct BenchmarkConfig {
     double runSeconds;
     const char* logPath;
     size_t warmupFrames;
+    TransformKernel transformKernel;
+    CubeRenderMode renderMode;
+    CubeTraversalMode traversalMode;
+    CubeParallelMode parallelMode;
+    DepthBufferMode depthMode;
+    RuntimeConfig runtime;
 } BenchmarkConfig;
 
 typedef struct BenchmarkStats {
@@ -61,6 +80,13 @@ typedef struct BenchmarkStats {
     double averageMs;
     double percentile95Ms;
     double maxMs;
+    size_t facesCulled;
+    size_t samplesCulled;
+    size_t itemsStolen;
+    size_t dirtyCells;
+    size_t instancesCulled;
+    size_t instancesOccluded;
+    size_t instancesDrawn;
 } BenchmarkStats;
 
 typedef struct MemorySnapshot {
@@ -310,6 +336,166 @@ static double parseRunSeconds(void)
     return clampRunSeconds(parsed);
 }
 
+static TransformKernel parseTransformKernel(void)
+{
+    const char* envValue = getenv(ENV_TRANSFORM_KERNEL);
+    if (envValue == NULL || envValue[0] == '\0') {
+        return getTransformKernel();
+    }
+
+    for (int kernel = TRANSFORM_KERNEL_SCALAR; kernel < TRANSFORM_KERNEL_COUNT; ++kernel) {
+        if (strcmp(envValue, getTransformKernelName((TransformKernel)kernel)) != 0) {
+            continue;
+        }
+        if (setTransformKernel((TransformKernel)kernel)) {
+            return (TransformKernel)kernel;
+        }
+        fprintf(stderr,
+                "[benchmark] Warning: %s kernel '%s' unsupported on this CPU. Using %s.\n",
+                ENV_TRANSFORM_KERNEL,
+                envValue,
+                getTransformKernelName(getTransformKernel()));
+        return getTransformKernel();
+    }
+
+    fprintf(stderr,
+            "[benchmark] Warning: invalid %s value '%s'. Using %s.\n",
+            ENV_TRANSFORM_KERNEL,
+            envValue,
+            getTransformKernelName(getTransformKernel()));
+    return getTransformKernel();
+}
+
+static const char* renderModeName(CubeRenderMode mode)
+{
+    return mode == CUBE_RENDER_SAMPLED ? "sampled" : "rasterized";
+}
+
+static CubeRenderMode parseRenderMode(CubeRenderMode defaultMode)
+{
+    const char* envValue = getenv(ENV_RENDER_MODE);
+    if (envValue == NULL || envValue[0] == '\0') {
+        return defaultMode;
+    }
+
+    if (strcmp(envValue, renderModeName(CUBE_RENDER_SAMPLED)) == 0) {
+        return CUBE_RENDER_SAMPLED;
+    }
+    if (strcmp(envValue, renderModeName(CUBE_RENDER_RASTERIZED)) == 0) {
+        return CUBE_RENDER_RASTERIZED;
+    }
+
+    fprintf(stderr,
+            "[benchmark] Warning: invalid %s value '%s'. Using %s.\n",
+            ENV_RENDER_MODE,
+            envValue,
+            renderModeName(defaultMode));
+    return defaultMode;
+}
+
+static const char* traversalModeName(CubeTraversalMode mode)
+{
+    return mode == CUBE_TRAVERSAL_TRANSFORM ? "transform" : "incremental";
+}
+
+static CubeTraversalMode parseTraversalMode(CubeTraversalMode defaultMode)
+{
+    const char* envValue = getenv(ENV_TRAVERSAL);
+    if (envValue == NULL || envValue[0] == '\0') {
+        return defaultMode;
+    }
+
+    if (strcmp(envValue, traversalModeName(CUBE_TRAVERSAL_TRANSFORM)) == 0) {
+        return CUBE_TRAVERSAL_TRANSFORM;
+    }
+    if (strcmp(envValue, traversalModeName(CUBE_TRAVERSAL_INCREMENTAL)) == 0) {
+        return CUBE_TRAVERSAL_INCREMENTAL;
+    }
+
+    fprintf(stderr,
+            "[benchmark] Warning: invalid %s value '%s'. Using %s.\n",
+            ENV_TRAVERSAL,
+            envValue,
+            traversalModeName(defaultMode));
+    return defaultMode;
+}
+
+static const char* parallelModeName(CubeParallelMode mode)
+{
+    return mode == CUBE_PARALLEL_WORK_STEALING ? "stealing" : "tiled";
+}
+
+static CubeParallelMode parseParallelMode(CubeParallelMode defaultMode)
+{
+    const char* envValue = getenv(ENV_PARALLEL);
+    if (envValue == NULL || envValue[0] == '\0') {
+        return defaultMode;
+    }
+
+    if (strcmp(envValue, parallelModeName(CUBE_PARALLEL_TILED)) == 0) {
+        return CUBE_PARALLEL_TILED;
+    }
+    if (strcmp(envValue, parallelModeName(CUBE_PARALLEL_WORK_STEALING)) == 0) {
+        return CUBE_PARALLEL_WORK_STEALING;
+    }
+
+    fprintf(stderr,
+            "[benchmark] Warning: invalid %s value '%s'. Using %s.\n",
+            ENV_PARALLEL,
+            envValue,
+            parallelModeName(defaultMode));
+    return defaultMode;
+}
+
+static const char* depthModeName(DepthBufferMode mode)
+{
+    switch (mode) {
+    case DEPTH_BUFFER_EPOCH:
+        return "epoch";
+    case DEPTH_BUFFER_PACKED:
+        return "packed";
+    default:
+        return "cleared";
+    }
+}
+
+static DepthBufferMode parseDepthMode(DepthBufferMode defaultMode)
+{
+    const char* envValue = getenv(ENV_DEPTH_BUFFER);
+    if (envValue == NULL || envValue[0] == '\0') {
+        return defaultMode;
+    }
+
+    if (strcmp(envValue, depthModeName(DEPTH_BUFFER_CLEARED)) == 0) {
+        return DEPTH_BUFFER_CLEARED;
+    }
+    if (strcmp(envValue, depthModeName(DEPTH_BUFFER_EPOCH)) == 0) {
+        return DEPTH_BUFFER_EPOCH;
+    }
+    if (strcmp(envValue, depthModeName(DEPTH_BUFFER_PACKED)) == 0) {
+        return DEPTH_BUFFER_PACKED;
+    }
+
+    fprintf(stderr,
+            "[benchmark] Warning: invalid %s value '%s'. Using %s.\n",
+            ENV_DEPTH_BUFFER,
+            envValue,
+            depthModeName(defaultMode));
+    return defaultMode;
+}
+
+static const char* arenaBackingName(RenderArenaBacking backing)
+{
+    switch (backing) {
+    case RENDER_ARENA_HUGETLB:
+        return "huge pages (MAP_HUGETLB)";
+    case RENDER_ARENA_TRANSPARENT_HUGE:
+        return "transparent huge pages (madvise)";
+    default:
+        return "regular pages";
+    }
+}
+
 static BenchmarkConfig loadBenchmarkConfig(void)
 {
     BenchmarkConfig config;
@@ -321,6 +507,16 @@ static BenchmarkConfig loadBenchmarkConfig(void)
                          : LOG_DEFAULT_PATH;
 
     config.warmupFrames = DEFAULT_WARMUP_FRAMES;
+    config.transformKernel = parseTransformKernel();
+
+    /* Unset variables keep the defaults of a fresh render context */
+    RenderContext defaults;
+    initializeRenderContext(&defaults);
+    config.renderMode = parseRenderMode(defaults.cube.renderMode);
+    config.traversalMode = parseTraversalMode(defaults.cube.traversalMode);
+    config.parallelMode = parseParallelMode(defaults.cube.parallelMode);
+    config.depthMode = parseDepthMode(defaults.depthBufferMode);
+    config.runtime = loadRuntimeConfig();
     return config;
 }
 
@@ -331,22 +527,39 @@ static void logConfigSummary(const BenchmarkConfig* config)
            config->runSeconds,
            MIN_RUN_SECONDS);
     printf("[benchmark] CSV output    : %s\n", config->logPath);
+    printf("[benchmark] SIMD kernel   : %s\n", getTransformKernelName(config->transformKernel));
+    printf("[benchmark] Render mode   : %s\n", renderModeName(config->renderMode));
+    if (config->renderMode == CUBE_RENDER_SAMPLED) {
+        printf("[benchmark] Traversal     : %s\n", traversalModeName(config->traversalMode));
+    }
+    printf("[benchmark] Threads       : %d\n", getThreadPoolSize());
+    printf("[benchmark] Parallel mode : %s\n", parallelModeName(config->parallelMode));
+    printf("[benchmark] Depth buffer  : %s\n", depthModeName(config->depthMode));
+    if (config->runtime.targetFps > 0) {
+        printf("[benchmark] Target FPS    : %d (deadline paced)\n", config->runtime.targetFps);
+    }
 }
 
-static bool renderSingleFrame(void)
+static bool renderSingleFrame(RenderContext* context)
 {
-    if (initializeFrameBuffer() != ALLOCATION_SUCCESS ||
-        initializeDepthBuffer() != ALLOCATION_SUCCESS) {
+    if (initializeFrameBuffer(context) != ALLOCATION_SUCCESS ||
+        initializeDepthBuffer(context) != ALLOCATION_SUCCESS) {
         fprintf(stderr, "[benchmark] Error: buffer initialization failed.\n");
         return false;
     }
 
-    drawCube(rotationAngles);
-    incrementRotationAngles();
+    if (context->scene != NULL) {
+        drawScene(context, context->scene, context->cube.rotation);
+    } else if (context->mesh != NULL) {
+        drawMesh(context, context->mesh, context->cube.rotation);
+    } else {
+        drawCube(context, context->cube.rotation);
+    }
+    incrementRotationAngles(context);
     return true;
 }
 
-static bool measureFrame(double* frameMs)
+static bool measureFrame(RenderContext* context, double* frameMs)
 {
     struct timespec frameStart;
     struct timespec frameEnd;
@@ -356,7 +569,7 @@ static bool measureFrame(double* frameMs)
         return false;
     }
 
-    if (!renderSingleFrame()) {
+    if (!renderSingleFrame(context)) {
         return false;
     }
 
@@ -369,10 +582,10 @@ static bool measureFrame(double* frameMs)
     return true;
 }
 
-static bool warmupRenderer(size_t warmupFrames)
+static bool warmupRenderer(RenderContext* context, size_t warmupFrames)
 {
     for (size_t frame = 0; frame < warmupFrames; ++frame) {
-        if (!renderSingleFrame()) {
+        if (!renderSingleFrame(context)) {
             return false;
         }
     }
@@ -380,6 +593,7 @@ static bool warmupRenderer(size_t warmupFrames)
 }
 
 static bool runBenchmark(const BenchmarkConfig* config,
+                         RenderContext* context,
                          DurationSeries* timings,
                          BenchmarkStats* stats)
 {
@@ -389,6 +603,12 @@ static bool runBenchmark(const BenchmarkConfig* config,
         return false;
     }
 
+    const bool paced = config->runtime.targetFps > 0;
+    if (paced && initializeFramePacer(config->runtime.targetFps) != ALLOCATION_SUCCESS) {
+        fprintf(stderr, "[benchmark] Error: unable to start frame pacer.\n");
+        return false;
+    }
+
     while (true) {
         struct timespec now;
         if (clock_gettime(CLOCK_MONOTONIC, &now) != 0) {
@@ -401,8 +621,14 @@ static bool runBenchmark(const BenchmarkConfig* config,
             break;
         }
 
+        /* Sleep until the frame is due; the wait is not part of frameMs */
+        if (paced) {
+            waitForFrameDeadline();
+            beginPacedFrame();
+        }
+
         double frameMs = 0.0;
-        if (!measureFrame(&frameMs)) {
+        if (!measureFrame(context, &frameMs)) {
             return false;
         }
 
@@ -411,6 +637,18 @@ static bool runBenchmark(const BenchmarkConfig* config,
             return false;
         }
 
+        const CubeCullStats cull = getCubeCullStats(context);
+        stats->facesCulled += (size_t)cull.facesCulled;
+        stats->samplesCulled += (size_t)cull.samplesCulled;
+        stats->itemsStolen += (size_t)getWorkStealStats(context).steals;
+        if (context->scene != NULL) {
+            stats->instancesCulled += (size_t)context->scene->stats.instancesCulled;
+            stats->instancesOccluded += (size_t)context->scene->stats.instancesOccluded;
+            stats->instancesDrawn += (size_t)context->scene->stats.instancesDrawn;
+        }
+        const RenderRect dirty = getRendererDirtyRect(context);
+        stats->dirtyCells += (size_t)(dirty.x1 - dirty.x0) * (size_t)(dirty.y1 - dirty.y0);
+
         stats->frameCount += 1;
         stats->totalMs += frameMs;
         if (frameMs > stats->maxMs) {
@@ -478,28 +716,77 @@ static void formatIsoTimestamp(char* buffer, size_t bufferSize)
 int main(void)
 {
     BenchmarkConfig config = loadBenchmarkConfig();
+    if (initializeThreadPool(config.runtime.renderThreads) != ALLOCATION_SUCCESS) {
+        fprintf(stderr, "[benchmark] Warning: thread pool unavailable, rendering single-threaded.\n");
+    }
     logConfigSummary(&config);
 
-    if (initializeRenderer(DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT) != ALLOCATION_SUCCESS) {
+    RenderContext context;
+    initializeRenderContext(&context);
+    context.cube.renderMode = config.renderMode;
+    context.cube.traversalMode = config.traversalMode;
+    context.cube.parallelMode = config.parallelMode;
+    context.depthBufferMode = config.depthMode;
+    context.hugePages = config.runtime.hugePages;
+
+    if (initializeRenderer(&context, DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT) != ALLOCATION_SUCCESS) {
         fprintf(stderr, "[benchmark] Error: renderer initialization failed.\n");
+        cleanupThreadPool();
         return EXIT_FAILURE;
     }
 
+    const RenderArena arena = getRendererArena(&context);
+    printf("[benchmark] Render arena  : %zu KiB on %s\n", arena.bytes / 1024, arenaBackingName(arena.backing));
+
+    Mesh mesh;
+    if (config.runtime.meshPath != NULL || config.runtime.instanceCount > 0) {
+        if (loadConfiguredMesh(&config.runtime, &context.cube, &mesh) != ALLOCATION_SUCCESS) {
+            fprintf(stderr, "[benchmark] Error: mesh loading failed.\n");
+            cleanupThreadPool();
+            cleanupRenderer(&context);
+            return EXIT_FAILURE;
+        }
+        context.mesh = &mesh;
+        printf("[benchmark] Mesh          : %s (%d vertices, %d triangles)\n",
+               config.runtime.meshPath != NULL ? config.runtime.meshPath : MESH_BUILTIN_CUBE,
+               mesh.vertexCount, mesh.triangleCount);
+    }
+    Scene scene;
+    if (config.runtime.instanceCount > 0) {
+        if (loadConfiguredScene(&config.runtime, &context.cube, &mesh, &scene) != ALLOCATION_SUCCESS) {
+            fprintf(stderr, "[benchmark] Error: scene setup failed.\n");
+            cleanupThreadPool();
+            destroyMesh(context.mesh);
+            cleanupRenderer(&context);
+            return EXIT_FAILURE;
+        }
+        context.scene = &scene;
+        printf("[benchmark] Scene         : %d instances in %d layer(s), %dx%d grid, occlusion culling %s\n",
+               scene.instanceCount, config.runtime.instanceLayers, scene.gridColumns, scene.gridRows,
+               scene.occlusionCulling ? "on" : "off");
+    }
+
     DurationSeries timings = {0};
     bool timingsInitialized = false;
 
     if (!durationSeriesInit(&timings, INITIAL_DURATION_CAPACITY)) {
         fprintf(stderr, "[benchmark] Error: unable to allocate timing buffer.\n");
-        cleanupRenderer();
+        cleanupThreadPool();
+        destroyScene(context.scene);
+        destroyMesh(context.mesh);
+        cleanupRenderer(&context);
         return EXIT_FAILURE;
     }
     timingsInitialized = true;
 
-    if (!warmupRenderer(config.warmupFrames)) {
+    if (!warmupRenderer(&context, config.warmupFrames)) {
         if (timingsInitialized) {
             durationSeriesFree(&timings);
         }
-        cleanupRenderer();
+        cleanupThreadPool();
+        destroyScene(context.scene);
+        destroyMesh(context.mesh);
+        cleanupRenderer(&context);
         return EXIT_FAILURE;
     }
 
@@ -507,11 +794,14 @@ int main(void)
     captureMemorySnapshot(&beforeSnapshot);
 
     BenchmarkStats stats = {0};
-    if (!runBenchmark(&config, &timings, &stats)) {
+    if (!runBenchmark(&config, &context, &timings, &stats)) {
         if (timingsInitialized) {
             durationSeriesFree(&timings);
         }
-        cleanupRenderer();
+        cleanupThreadPool();
+        destroyScene(context.scene);
+        destroyMesh(context.mesh);
+        cleanupRenderer(&context);
         return EXIT_FAILURE;
     }
 
@@ -527,6 +817,31 @@ int main(void)
     printf("  Average Frame Time   : %.3f ms\n", stats.averageMs);
     printf("  95th Percentile      : %.3f ms\n", stats.percentile95Ms);
     printf("  Max Frame Time       : %.3f ms\n", stats.maxMs);
+    printf("  Faces Culled / Frame : %.2f\n",
+           (double)stats.facesCulled / (double)stats.frameCount);
+    printf("  Samples Culled/Frame : %.1f\n",
+           (double)stats.samplesCulled / (double)stats.frameCount);
+    printf("  Dirty Cells / Frame  : %.1f of %d\n",
+           (double)stats.dirtyCells / (double)stats.frameCount, context.bufferSize);
+    if (context.scene != NULL) {
+        printf("  Instances Drawn/Frame: %.1f of %d\n",
+               (double)stats.instancesDrawn / (double)stats.frameCount, context.scene->instanceCount);
+        printf("  Instances Culled/Frm : %.1f\n",
+               (double)stats.instancesCulled / (double)stats.frameCount);
+        printf("  Instances Hidden/Frm : %.1f\n",
+               (double)stats.instancesOccluded / (double)stats.frameCount);
+    }
+    if (config.runtime.targetFps > 0) {
+        const FramePacingStats pacing = getFramePacingStats();
+        printf("  Missed Deadlines     : %ld\n", pacing.missedDeadlines);
+        printf("  Lateness p50/p95/p99 : %.3f / %.3f / %.3f ms\n",
+               pacing.p50LatenessMs, pacing.p95LatenessMs, pacing.p99LatenessMs);
+        printf("  Max Lateness         : %.3f ms\n", pacing.maxLatenessMs);
+    }
+    if (config.parallelMode == CUBE_PARALLEL_WORK_STEALING) {
+        printf("  Items Stolen / Frame : %.2f\n",
+               (double)stats.itemsStolen / (double)stats.frameCount);
+    }
     printf("  Max RSS (before)     : %ld KiB\n", beforeSnapshot.ruMaxRssKiB);
     printf("  Max RSS (after)      : %ld KiB\n", afterSnapshot.ruMaxRssKiB);
     printf("  RSS delta            : %ld KiB\n",
@@ -553,6 +868,9 @@ int main(void)
     if (timingsInitialized) {
         durationSeriesFree(&timings);
     }
-    cleanupRenderer();
+    cleanupThreadPool();
+    destroyScene(context.scene);
+    destroyMesh(context.mesh);
+    cleanupRenderer(&context);
     return EXIT_SUCCESS;
 }
\ No newline at end of file